@@ -388,22 +388,29 @@
 
 
 
+# include <stdbool.h>
+
 # include "dependency.h"
+# include "exfc_check.h"
 
 # define EXCEPT_FMT "Threw the %s:\n\tat %s:%ld, func %s\n\"%s\"\n"
 # define DEF_EXCEPT_FMT "Threw the %s\n"
+# define CAUSE_FMT "Caused by the %s:\n\tat %s:%ld, func %s\n\"%s\"\n"
+
+# ifndef EXCEP_BUFF_MAX
+#  define EXCEP_BUFF_MAX 4096
+# endif /* NO EXCEP_BUFF_MAX */
+
+# ifndef EXCEP_ARRAY_MAX
+#  define EXCEP_ARRAY_MAX 511
+# endif /* NO EXCEP_ARRAY_MAX */
 
-enum Except_t {
-  UnknownException = EXCEP_ID_OFFSET,
-  InstanceFailureException,
-  IllegalMemoryAccessException,
-  InvalidArgumentException,
-  OutOfBoundException,
-  InvalidNullPointerException,
-  OutOfMemoryException,
-  BufferOverflowException,
-  InternalException
-};
+# ifndef EXCEP_ID_OFFSET
+#  define EXCEP_ID_OFFSET 1
+# endif /* NO EXCEP_ID_OFFSET */
+
+/* enum Except_t, generated from src/exceptions.def. */
+# include "exfc_gen_except.h"
 
 typedef struct _Exceptions
 {
@@ -414,24 +421,251 @@ typedef struct _Exceptions
 
 static Carray _gExcepArr;
 
-static inline void
-THROW(Exceptions except, const char *__restrict__ file, long int line,
+/* The registry, defined in src/exfc.c. */
+extern _excep_t _excep_arr[EXCEP_ARRAY_MAX];
+extern const int _excep_arr_len;
+
+/**
+ * @brief Registry entry at IDX, for code outside src/exfc.c.
+ * @param idx Index into the registry.
+ * @return The entry, which is empty once nothing is registered there;\n
+ * @return NULL once IDX is out of range;
+ */
+const _excep_t *
+_exfc_getexcep(int idx);
+
+/**
+ * @brief Compare two exception by their ID;
+ * @param a The first exception to be compared.
+ * @param b The second exception to be compared.
+ * @note Fails once any given parameter was null;
+ * @return @b IDENTICAL once $A = $B;\n
+ * @return @b GREATER   once $A > $B;\n
+ * @return @b LESS      once $A < $B;
+ */
+int
+exfc_cmp(_excep_t *a, _excep_t *b);
+
+/**
+ * @brief By specifying the name & the description & the ID, an exception can
+ *        be added once no same exception exists in advance.
+ * @param name Name to the exception being added.
+ * @param description Description to the exception being added.
+ * @param id ID to the exception being added.
+ * @note Fails once any given parameter was null, except $id.
+ * @return Index to the exception being added;\n
+ * @return @b CONDITIONAL once $_excep_arr was full;\n
+ * @return @b DUPLICATED  once $_excep_arr had a same element;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_addexcep(const char *name, const char *description, int id);
+
+/* For test only. */
+int
+_exfc_addexcep_test(const void *name, const void *description, int id);
+
+/**
+ * @brief By specifying the name, an exception can be removed once it exists.
+ * @param name The name used to search for desired exception to be removed.
+ * @note Fails once any given parameter was null.
+ * @return Index to the exception being removed;\n
+ * @return @b MISSING     once $_excep_arr had no desired exception;\n
+ * @return @b CONDITIONAL once $_excep_arr was empty;\n
+ * @return @b FAILED      once $id < 0;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_removeexcep_byname(const char *name);
+
+/**
+ * @brief By specifying the id, an exception can be removed once it exists.
+ * @param id The ID used to search for desired exception to be removed.
+ * @return Index to the exception being removed;\n
+ * @return @b MISSING     once $_excep_arr had no desired exception;\n
+ * @return @b CONDITIONAL once $_excep_arr was empty;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_removeexcep_byid(int id);
+
+/**
+ * @brief Return all exceptions.
+ * @return A pointer towards $_excep_arr;\n
+ * @return $excep_nullptr once _excep_arr is NULL;
+ * @exception InvalidNullPointerException
+ */
+_excep_t *
+exfc_getallexcep();
+
+/**
+ * @brief Find desired exception with its name;
+ * @param name The name used to search for desired exception.
+ * @note Fails once any given parameter was null.
+ * @return Index of the exception being found;\n
+ * @return @b MISSING  once NOT found;\n
+ * @return @b ABNORMAL once $_excep_arr was null;
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_getindex_byname(const char *name);
+
+/**
+ * @brief Find desired exception with its ID;
+ * @param name The ID used to search for desired exception.
+ * @note Fails once any given parameter was null.
+ * @return Index of the exception being found;\n
+ * @return @b MISSING  once NOT found;\n
+ * @return @b ABNORMAL once $_excep_arr was null;
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_getindex_byid(int id);
+
+/**
+ * @brief Iterate through every element in $_excep_arr, until find specified
+ *        exception.
+ * @param e The exception used to search for desired exception.
+ * @note Fails once any given parameter was null.
+ * @return Index of matched exception;\n
+ * @return @b CONDITIONAL once $e was excep_null, which is not allowed to
+ *                        operate on it;\n
+ * @return @b MISSING     once NOT found;\n
+ * @return @b FAILED      once id < 0;
+ *                        once operating target is $excep_null;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception InvalidNullPointerException
+ */
+int
+exfc_getindex_byexcep(_excep_t e);
+
+/**
+ * @brief Iterate through every element in $_excep_arr, until find the last
+ *        exception.
+ * @return Index of matched exception;\n
+ * @return @b CONDITIONAL once $_excep_arr was empty;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception InvalidNullPointerException
+ */
+int
+_exfc_iteration_last();
+
+/**
+ * @brief Iterate through every element in $_excep_arr, until find the first
+ *        exception.
+ * @return Index of matched exception;\n
+ * @return @b CONDITIONAL once $_excep_arr was empty;\n
+ * @return @b ABNORMAL    once $_excep_arr was null;
+ * @exception InvalidNullPointerException
+ */
+int
+_exfc_iteration_first();
+
+/**
+ * @brief Rearrange whole array to make all the elements listed near-by.
+ * @return Real length of _excep_arr after rearrangement;\n
+ * @return @b ABNORMAL once $_excep_arr was null;
+ * @exception InvalidNullPointerException
+ */
+int
+_exfc_rearrangement();
+
+/**
+ * @brief Rearrange whole array to make all the elements listed near-by without
+ *   an extra array used.
+ * @return Real length of $_excep_arr after rearrangement;\n
+ * @return @b ABNORMAL once $_excep_arr was null;
+ * @exception InvalidNullPointerException
+ */
+int
+_exfc_rearrangement_inplace();
+
+/**
+ * @brief Compare string $A and string $B in a quick way.\n
+ * @param a The first string to be compared.
+ * @param b The second string to be compared.
+ * @param capital_restricted Specify whether to restrict on capitalisation.
+ * That is, once single character does not match, it stops following operations.
+ * @note Fails once any given parameter was null. except $capital_restricted.
+ * @note Transacts FAILED    from _exfc_capital_check(char, char, bool);\n
+ *                 ABNORMAL  from _exfc_capital_check(char, char, bool);
+ * @return @b IDENTICAL once matched;\n
+ * @return @b DIFFERENT once did not match.
+ */
+int
+_exfc_quick_match_str(const char *a, const char *b, bool capital_restricted);
+
+/**
+ * @brief Check whether the characters are exactly the same by comparing their
+ *        ASCII values.
+ * @param a The first letter to be checked.
+ * @param b The second letter to be checked.
+ * @param capital_restricted Specify whether to restrict on capitalisation.
+ * @return @b IDENTICAL once $A is exactly the same as $B;\n
+ * @return @b DIFFERENT once $A is not exactly the same as $B;
+ */
+int
+_exfc_capital_check(char a, char b, bool capital_restricted);
+
+/**
+ * @brief This function specifically throw BufferOverflowException once given
+ *        BUFF is longer than $EXCEP_BUFF_MAX.
+ * @param buff The buffer to be checked.
+ * @note Fails once any given parameter was null.
+ * @return @b FAILED   once failed passing through macro "fail";\n
+ * @return @b ABNORMAL once $_excep_arr was null;\n
+ * @return @b NORMAL   once normally proceeded with no error occurred;\n
+ * @exception BufferOverflowException
+ * @exception InvalidNullPointerException
+ */
+int
+_exfc_buffersize_chk(char *buff);
+
+/**
+ * @brief Swap specified two element from $_excep_arr;
+ * @param a The first partial exception to be swapped.
+ * @param a The second partial exception to be swapped.
+ * @note Fails once any given parameter was null;
+ * @return @b FAILED once failed passing through macro "fail";\n
+ * @return @b NORMAL normally proceeded with no error occurred;
+ */
+int
+_exfc_swap(_excep_t *a, _excep_t *b);
+
+/**
+ * @brief The slow path of THROW. Kept out of line and in the cold section,
+ *        so callers of THROW only pay for a call.
+ * @param except The exception specified to be thrown.
+ * @param file The macro __FILE__ provided under promise on calling.
+ * @param line The macro __LINE__ provided under promise on calling.
+ * @param function The macro __FUNCTION__ provided under promise on calling.
+ * @param fmt The format to variadic list used on outputting.
+ * @return The policy of the handler of $except, once it let THROW return;
+ *         see exfc_handler.h. Otherwise never returns.
+ */
+__attribute__((noinline, cold)) int
+_exfc_throw(_excep_t *except, const char *__restrict__ file, long int line,
+            const char *__restrict__ function, const char *__restrict__ fmt);
+
+__attribute__((always_inline)) static inline int
+THROW(_excep_t *except, const char *__restrict__ file, long int line,
   const char *__restrict__ function, const char *__restrict__ fmt)
 {
-  Exception *E = _read_from_array_exceptions(e);
-  
-  (void)fprintf(stderr, ((_file_ == NULL && _line_ == -1 && _function_ == NULL)
-    ? DEF_EXCEPT_FMT
-    /* Ignore _FMT when outputting the exception title.
-       Use _EXCEPT_FMT instead. */
-    : EXCEPT_FMT), except->_name, _file_, _line_, _function_,
-                   except->_description);
-
-  exit(except->_id);  // Try using memctl (credit: Wilhelm-Lee@github.com) to
-                 // solve such issues by retracing back to caller.
-                 // Direct usage of exit(int):void is NOT recommanded. It 
-                 // damages thead-safe in long-term consideration.
+  const int rtn = _exfc_throw(except, file, line, function, fmt);
+
+  /* Never a tail call: the function throwing stays on the stack for
+     exfc_prof & debuggers. */
+  __asm__ __volatile__ ("" ::: "memory");
 
+  return rtn;
 }
 
 static inline void
@@ -445,5 +679,79 @@ _exfc_init_exceparr(Carray *src)
   
 }
 
+/**
+ * @brief Hash LEN bytes from S with 32-bit FNV-1a.
+ * @param s The bytes to be hashed.
+ * @param len Amount of bytes to be hashed.
+ * @return The hash value.
+ */
+static inline unsigned int
+_exfc_hash_str(const char *s, unsigned long len)
+{
+  unsigned int h = 2166136261u;
+
+  for (register unsigned long i = 0; i < len; i ++)
+    {
+      h ^= (unsigned char)s[i];
+      h *= 16777619u;
+    }
+  return h;
+}
+
+/**
+ * @brief Same as exfc_addexcep, with the length of NAME given. $len is
+ *        only checked with one memchr; the lookups use it as it is.
+ * @param len Length of $name, excluding the terminating null byte; must
+ *            equal strlen($name).
+ * @return Same as exfc_addexcep;\n
+ * @return @b FAILED once $len > EXCEP_BUFF_MAX, after throwing
+ *         BufferOverflowException;\n
+ * @return @b FAILED once $len was not strlen($name);
+ */
+int
+exfc_addexcep_n(const char *name, unsigned long len, const char *description,
+                int id);
+
+/**
+ * @brief Same as exfc_removeexcep_byname, with the length of NAME given.
+ * @param len Length of $name; must equal strlen($name).
+ * @return Same as exfc_removeexcep_byname;\n
+ * @return @b FAILED once $len > EXCEP_BUFF_MAX, after throwing
+ *         BufferOverflowException;\n
+ * @return @b FAILED once $len was not strlen($name);
+ */
+int
+exfc_removeexcep_byname_n(const char *name, unsigned long len);
+
+/**
+ * @brief Same as exfc_getindex_byname, with the length of NAME given.
+ *        Stored names are walked along with $name, never measured.
+ * @param len Length of $name; must equal strlen($name).
+ * @return Same as exfc_getindex_byname;\n
+ * @return @b FAILED once $len > EXCEP_BUFF_MAX, after throwing
+ *         BufferOverflowException;\n
+ * @return @b FAILED once $len was not strlen($name);
+ */
+int
+exfc_getindex_byname_n(const char *name, unsigned long len);
+
+/**
+ * @brief Same as _exfc_quick_match_str, with the length of A given.
+ */
+int
+_exfc_quick_match_str_n(const char *a, unsigned long lenA, const char *b,
+                        bool capital_restricted);
+
+/**
+ * @brief Measure BUFF, reading at most EXCEP_BUFF_MAX + 1 bytes, and throw
+ *        BufferOverflowException once it was longer than EXCEP_BUFF_MAX.
+ * @param len Receives the length; EXCEP_BUFF_MAX + 1 once too long.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL once it fit;\n
+ * @return @b FAILED once too long, or failed passing through macro "fail";
+ */
+int
+_exfc_buffersize_chk_n(const char *buff, unsigned long *len);
+
 #endif /* NO EXFC_H */
 
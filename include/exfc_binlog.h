@@ -0,0 +1,101 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_binlog.h
+ * @brief Compact binary exception log. While open, THROW writes a small
+ *        record instead of the text of EXCEPT_FMT; tools/exfcdec turns the
+ *        log back into text offline. The format of the log is in
+ *        exfc_binlog_fmt.h.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_BINLOG_H
+# define EXFC_BINLOG_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "exfc.h"
+# include "exfc_binlog_fmt.h"
+
+# ifndef EXFC_BINLOG_BUFF_MAX
+#  define EXFC_BINLOG_BUFF_MAX 65536
+# endif /* NO EXFC_BINLOG_BUFF_MAX */
+
+/**
+ * @brief Start logging into a new file at PATH.
+ * @param path Path to the log file; truncated once existed.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL     once opened;\n
+ * @return @b DUPLICATED once a log was already open;\n
+ * @return @b FAILED     once failed passing through macro "fail";\n
+ * @return @b ABNORMAL   once opening or writing failed;
+ */
+int
+exfc_binlog_open(const char *path);
+
+/**
+ * @brief Whether a log is open.
+ */
+bool
+exfc_binlog_enabled();
+
+/**
+ * @brief Append one event to the log.
+ * @param except The exception thrown.
+ * @param file The macro __FILE__ provided under promise on calling.
+ * @param line The macro __LINE__ provided under promise on calling.
+ * @param function The macro __FUNCTION__ provided under promise on calling.
+ * @param arg Raw argument bytes stored with the event; may be NULL.
+ * @param len Amount of bytes in $arg.
+ * @note Fails once $except was null.
+ * @return @b NORMAL   once recorded;\n
+ * @return @b MISSING  once no log was open;\n
+ * @return @b FAILED   once failed passing through macro "fail";\n
+ * @return @b ABNORMAL once writing failed;
+ */
+int
+exfc_binlog_record(const _excep_t *except, const char *file, long int line,
+                   const char *function, const void *arg, size_t len);
+
+/**
+ * @brief Write buffered records out.
+ * @return @b NORMAL   once flushed;\n
+ * @return @b MISSING  once no log was open;\n
+ * @return @b ABNORMAL once writing failed;
+ */
+int
+exfc_binlog_flush();
+
+/**
+ * @brief Write buffered records out from a signal handler. Only calls
+ *        write(2), and gives up at once should the log be busy.
+ */
+void
+_exfc_binlog_flush_signal();
+
+/**
+ * @brief Flush and close the log.
+ * @return @b NORMAL   once closed;\n
+ * @return @b MISSING  once no log was open;\n
+ * @return @b ABNORMAL once writing failed;
+ */
+int
+exfc_binlog_close();
+
+#endif /* NO EXFC_BINLOG_H */
@@ -0,0 +1,79 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_binlog_fmt.h
+ * @brief Wire format of the binary exception log, shared by the writer in
+ *        src/exfc_binlog.c and the decoder in tools/exfcdec.c. Includes
+ *        nothing, so the decoder builds without the rest of ExFC.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_BINLOG_FMT_H
+# define EXFC_BINLOG_FMT_H
+
+/*
+   Log layout:
+
+   "EXFCBLG1" varint(start time, microseconds since the Epoch)
+   then records, each beginning with a tag byte:
+
+   EXFC_BINLOG_TAG_EXCEP  varint(zigzag id) str(name) str(description)
+   EXFC_BINLOG_TAG_SITE   varint(site) varint(zigzag line) str(file)
+                          str(function)
+   EXFC_BINLOG_TAG_EVENT  varint(zigzag id) varint(site)
+                          varint(microseconds since previous event)
+                          varint(length) bytes(arguments)
+
+   str is varint(length) followed by the bytes. varint is unsigned LEB128;
+   zigzag maps signed values onto unsigned ones so small negatives stay
+   small. An exception or a site is described once, before the first event
+   referring to it. Site 0 stands for an unknown site.
+*/
+
+# define EXFC_BINLOG_MAGIC "EXFCBLG1"
+# define EXFC_BINLOG_MAGIC_LEN 8
+
+# define EXFC_BINLOG_TAG_EXCEP 0x01
+# define EXFC_BINLOG_TAG_SITE 0x02
+# define EXFC_BINLOG_TAG_EVENT 0x03
+
+/* Capacity of the site & exception dictionaries, power of 2. */
+# ifndef EXFC_BINLOG_DICT_MAX
+#  define EXFC_BINLOG_DICT_MAX 4096
+# endif /* NO EXFC_BINLOG_DICT_MAX */
+
+/* Arguments longer than this are truncated. */
+# ifndef EXFC_BINLOG_ARG_MAX
+#  define EXFC_BINLOG_ARG_MAX 1024
+# endif /* NO EXFC_BINLOG_ARG_MAX */
+
+/* Strings longer than this are truncated. Same as in exfc.h. */
+# ifndef EXCEP_BUFF_MAX
+#  define EXCEP_BUFF_MAX 4096
+# endif /* NO EXCEP_BUFF_MAX */
+
+/* Text of a decoded event; same as in exfc.h. */
+# ifndef EXCEPT_FMT
+#  define EXCEPT_FMT "Threw the %s:\n\tat %s:%ld, func %s\n\"%s\"\n"
+# endif /* NO EXCEPT_FMT */
+
+# ifndef DEF_EXCEPT_FMT
+#  define DEF_EXCEPT_FMT "Threw the %s\n"
+# endif /* NO DEF_EXCEPT_FMT */
+
+#endif /* NO EXFC_BINLOG_FMT_H */
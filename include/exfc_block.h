@@ -0,0 +1,136 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_block.h
+ * @brief ID blocks for modules. A module reserves a contiguous block of
+ *        IDs once loaded, registers its exceptions relative to the start of
+ *        the block, and releases the whole block once unloaded:
+ *
+ *        exfc_block b;
+ *        exfc_block_reserve("libfoo", 16, &b);
+ *        exfc_block_addexcep(&b, "FooException", "...", 0);
+ *        ...
+ *        exfc_block_release(&b);
+ *
+ *        Blocks are packed first-fit from EXFC_BLOCK_ID_BASE, so module IDs
+ *        stay dense and within reach of the handler table.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_BLOCK_H
+# define EXFC_BLOCK_H
+
+# include "exfc.h"
+# include "exfc_handler.h"
+
+/* IDs below are left to the predefined & generated exceptions. */
+# ifndef EXFC_BLOCK_ID_BASE
+#  define EXFC_BLOCK_ID_BASE 1024
+# endif /* NO EXFC_BLOCK_ID_BASE */
+
+/* First ID past the space blocks are taken from. */
+# ifndef EXFC_BLOCK_ID_END
+#  define EXFC_BLOCK_ID_END EXFC_HANDLER_ID_MAX
+# endif /* NO EXFC_BLOCK_ID_END */
+
+/* Blocks reserved at a time. */
+# ifndef EXFC_BLOCK_MAX
+#  define EXFC_BLOCK_MAX 128
+# endif /* NO EXFC_BLOCK_MAX */
+
+/**
+ * \struct exfc_block include/exfc_block.h exfc_block.h
+ * IDs [$_base, $_base + $_count) belong to $_module.
+ */
+typedef struct _exfc_block_S
+{
+  const char *_module;
+  int _base;
+  int _count;
+} exfc_block;
+
+/**
+ * @brief Reserve COUNT contiguous IDs for MODULE.
+ * @param module Name of the module; kept by pointer, like exception names.
+ * @param count Amount of IDs.
+ * @param out Receives the block.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL      once reserved;\n
+ * @return @b DUPLICATED  once $module already held a block, which is put
+ *                        into $out;\n
+ * @return @b CONDITIONAL once no gap was large enough, or out of blocks,
+ *                        or $module's former block was still being
+ *                        released;\n
+ * @return @b FAILED      once failed passing through macro "fail";
+ */
+int
+exfc_block_reserve(const char *module, int count, exfc_block *out);
+
+/**
+ * @brief Remove every exception registered in BLOCK, detach their handlers,
+ *        and give the IDs back. The IDs are not reserved by anyone else
+ *        before all of it is done.
+ * @note Fails once any given parameter was null.
+ * @return Amount of exceptions removed;\n
+ * @return @b MISSING once $block was not reserved;\n
+ * @return @b FAILED  once failed passing through macro "fail";
+ */
+int
+exfc_block_release(const exfc_block *block);
+
+/**
+ * @brief Find the block reserved by MODULE.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL  once found, put into $out;\n
+ * @return @b MISSING once NOT found;\n
+ * @return @b FAILED  once failed passing through macro "fail";
+ */
+int
+exfc_block_find(const char *module, exfc_block *out);
+
+/**
+ * @brief Find the block ID falls in, by binary search.
+ * @note Fails once $out was null.
+ * @return @b NORMAL  once found, put into $out;\n
+ * @return @b MISSING once $id belonged to no block;\n
+ * @return @b FAILED  once failed passing through macro "fail";
+ */
+int
+exfc_block_owner(int id, exfc_block *out);
+
+/**
+ * @brief Same as exfc_addexcep, with the ID given relative to BLOCK.
+ * @param rel Offset of the ID in $block.
+ * @return Same as exfc_addexcep;\n
+ * @return @b CONDITIONAL once $rel was out of [0, $block->_count);\n
+ * @return @b MISSING     once $block was no longer reserved;
+ */
+int
+exfc_block_addexcep(const exfc_block *block, const char *name,
+                    const char *description, int rel);
+
+/**
+ * @brief Return the absolute ID at REL in BLOCK; -1 once out of it.
+ */
+static inline int
+exfc_block_id(const exfc_block *block, int rel)
+{
+  return ((rel < 0 || rel >= block->_count) ? -1 : block->_base + rel);
+}
+
+#endif /* NO EXFC_BLOCK_H */
@@ -0,0 +1,117 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_catch.h
+ * @brief Catch contexts. While a context is active on current thread, THROW
+ *        and the fault handler hand the exception over to it instead of
+ *        exiting.
+ *
+ *        exfc_catch c;
+ *        if (EXFC_TRY(c))
+ *          {
+ *            ...
+ *            exfc_catch_pop(&c);
+ *          }
+ *        else
+ *          {
+ *            c._except was thrown at c._file:c._line.
+ *          }
+ *
+ *        Needs POSIX sigsetjmp; build with -std=gnu99 or define
+ *        _DEFAULT_SOURCE.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_CATCH_H
+# define EXFC_CATCH_H
+
+# include <setjmp.h>
+# include <stddef.h>
+
+# include "exfc.h"
+
+/**
+ * \struct exfc_catch include/exfc_catch.h exfc_catch.h
+ */
+typedef struct _exfc_catch_S
+{
+  sigjmp_buf _env;
+  _excep_t _except;
+  const char *_file;
+  const char *_function;
+  long int _line;
+  /* Faulting address & signal number once raised by a signal, or NULL & 0 */
+  void *_addr;
+  int _signo;
+  /* Newest cause of $_except, see exfc_chain.h */
+  struct _exfc_cause_S *_cause;
+  /* Payload once thrown again by exfc_task_join, or NULL & 0; lives in the
+     task, see exfc_task.h */
+  const void *_payload;
+  size_t _payload_len;
+  struct _exfc_catch_S *_prev;
+} exfc_catch;
+
+/* Innermost active context of current thread. */
+extern __thread exfc_catch *_exfc_catch_top;
+
+/**
+ * @brief Activate CTX on current thread. Use EXFC_TRY instead.
+ * @param ctx The context to be activated.
+ * @return $ctx.
+ */
+static inline exfc_catch *
+exfc_catch_push(exfc_catch *ctx)
+{
+  ctx->_addr = NULL;
+  ctx->_signo = 0;
+  ctx->_cause = NULL;
+  ctx->_payload = NULL;
+  ctx->_payload_len = 0;
+  ctx->_prev = _exfc_catch_top;
+  _exfc_catch_top = ctx;
+
+  return ctx;
+}
+
+/**
+ * @brief Deactivate CTX, which must be the innermost context. Call it once
+ *        the protected region completed normally.
+ * @param ctx The context to be deactivated.
+ */
+static inline void
+exfc_catch_pop(exfc_catch *ctx)
+{
+  _exfc_catch_top = ctx->_prev;
+}
+
+/**
+ * @brief Deactivate the innermost context and jump back into it.
+ *        Async-signal-safe.
+ * @note The signal mask is NOT saved nor restored; the fault handler is
+ *       installed with SA_NODEFER for that reason.
+ */
+__attribute__((noreturn)) void
+_exfc_catch_raise(exfc_catch *ctx);
+
+/* Evaluates nonzero on entering, zero once an exception was caught. Must be
+   the whole controlling expression of an "if", as sigsetjmp requires.
+   The signal mask is not saved, keeping EXFC_TRY free of system calls. */
+# define EXFC_TRY(ctx) (sigsetjmp(exfc_catch_push(&(ctx))->_env, 0) == 0)
+
+#endif /* NO EXFC_CATCH_H */
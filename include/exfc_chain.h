@@ -0,0 +1,136 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_chain.h
+ * @brief Exception chaining. Rethrowing a caught exception with a cause
+ *        keeps the caught one, and everything it was caused by, in a chain
+ *        of cause nodes. Nodes come from a fixed per-thread pool; both
+ *        adding a cause and dropping the whole chain cost constant time.
+ *
+ *        exfc_catch c;
+ *        if (EXFC_TRY(c))
+ *          {
+ *            ...   (throws OutOfBoundException)
+ *            exfc_catch_pop(&c);
+ *          }
+ *        else
+ *          {
+ *            THROW_WITH_CAUSE(&internal, c);
+ *          }
+ *
+ *        The chain of a thread is dropped by its next THROW, so causes
+ *        read from a catch context are valid until then.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_CHAIN_H
+# define EXFC_CHAIN_H
+
+# include "exfc_catch.h"
+
+/* Cause nodes per thread. Causes beyond it are counted, not kept. */
+# ifndef EXFC_CHAIN_MAX
+#  define EXFC_CHAIN_MAX 64
+# endif /* NO EXFC_CHAIN_MAX */
+
+/**
+ * \struct exfc_cause include/exfc_chain.h exfc_chain.h
+ */
+typedef struct _exfc_cause_S
+{
+  _excep_t _except;
+  const char *_file;
+  const char *_function;
+  long int _line;
+  /* The cause of this cause; NULL for the original one. */
+  struct _exfc_cause_S *_next;
+} exfc_cause;
+
+/**
+ * @brief Return the newest cause of current thread, NULL once none.
+ */
+exfc_cause *
+exfc_chain_head();
+
+/**
+ * @brief Return how many causes of current thread were dropped since
+ *        the pool was exhausted.
+ */
+unsigned int
+exfc_chain_dropped();
+
+/**
+ * @brief Put the whole chain of current thread back into the pool.
+ */
+void
+exfc_chain_clear();
+
+/**
+ * @brief Add CTX's exception as the newest cause. Called by
+ *        exfc_rethrow.
+ * @param ctx The catch context holding the caught exception.
+ * @return @b NORMAL      once added;\n
+ * @return @b CONDITIONAL once the pool was exhausted and it was dropped;\n
+ * @return @b FAILED      once failed passing through macro "fail";
+ */
+int
+_exfc_chain_push(const exfc_catch *ctx);
+
+/**
+ * @brief Add EXCEPT, thrown at FILE:LINE, as the newest cause.
+ * @return @b NORMAL      once added;\n
+ * @return @b CONDITIONAL once the pool was exhausted and it was dropped;\n
+ * @return @b FAILED      once failed passing through macro "fail";
+ */
+int
+_exfc_chain_push_site(const _excep_t *except, const char *file,
+                      long int line, const char *function);
+
+/**
+ * @brief Make the next _exfc_throw on current thread keep the chain.
+ */
+void
+_exfc_chain_set_keep();
+
+/**
+ * @brief Whether the throw in progress keeps the current chain. Consumed by
+ *        _exfc_throw: a THROW without cause drops the chain.
+ */
+bool
+_exfc_chain_take_keep();
+
+/**
+ * @brief Throw EXCEPT, caused by the exception caught in CTX.
+ * @param except The exception specified to be thrown.
+ * @param ctx The catch context holding the cause.
+ * @param file The macro __FILE__ provided under promise on calling.
+ * @param line The macro __LINE__ provided under promise on calling.
+ * @param function The macro __FUNCTION__ provided under promise on calling.
+ * @param fmt The format to variadic list used on outputting.
+ * @return Same as _exfc_throw.
+ */
+__attribute__((noinline, cold)) int
+exfc_rethrow(_excep_t *except, const exfc_catch *ctx,
+             const char *__restrict__ file, long int line,
+             const char *__restrict__ function,
+             const char *__restrict__ fmt);
+
+# define THROW_WITH_CAUSE(except, ctx)                                      \
+  exfc_rethrow((except), &(ctx), __FILE__, __LINE__, __FUNCTION__, NULL)
+
+#endif /* NO EXFC_CHAIN_H */
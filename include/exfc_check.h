@@ -0,0 +1,96 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_check.h
+ * @brief Check macros. The expected outcome of every check is hinted to the
+ *        compiler, and everything done on failure lives in out-of-line cold
+ *        stubs, so the inlined part of a check is one compare & one branch.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_CHECK_H
+# define EXFC_CHECK_H
+
+# if defined(__GNUC__) || defined(__clang__)
+#  define EXFC_LIKELY(x) __builtin_expect(!!(x), 1)
+#  define EXFC_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#  define EXFC_COLD __attribute__((noinline, cold))
+# else
+#  define EXFC_LIKELY(x) (x)
+#  define EXFC_UNLIKELY(x) (x)
+#  define EXFC_COLD
+# endif /* __GNUC__ || __clang__ */
+
+/**
+ * \struct exfc_check_site include/exfc_check.h exfc_check.h
+ * Where the latest failed check of current thread was.
+ */
+typedef struct _exfc_check_site_S
+{
+  const char *_expr;
+  const char *_file;
+  const char *_function;
+  long int _line;
+  int _rtn;
+} exfc_check_site;
+
+/**
+ * @brief Record a failed check. Cold; never inlined.
+ * @note Prints the site to stderr once EXFC_CHECK_VERBOSE was defined on
+ *       building ExFC.
+ */
+EXFC_COLD void
+_exfc_check_fail(const char *expr, const char *file, long int line,
+                 const char *function, int rtn);
+
+/**
+ * @brief Return the latest failed check of current thread.
+ * @return The site, whose $_expr is NULL once no check has failed.
+ */
+exfc_check_site
+exfc_check_last();
+
+/**
+ * @brief Return RTN from current function once COND does not hold.
+ */
+# define EXFC_CHECK(cond, rtn)                                               \
+  do                                                                        \
+    {                                                                       \
+      if (EXFC_UNLIKELY(!(cond)))                                           \
+        {                                                                   \
+          _exfc_check_fail(#cond, __FILE__, __LINE__, __FUNCTION__,         \
+                           (int)(long)(rtn));                               \
+          return (rtn);                                                     \
+        }                                                                   \
+    }                                                                       \
+  while (0)
+
+/**
+ * @brief Return RTN from current function once PTR was null.
+ *        Replaces macro "fails".
+ */
+# define EXFC_FAILS(ptr, rtn) EXFC_CHECK((ptr) != NULL, rtn)
+
+/**
+ * @brief Return RTN from current function once VAL equals RTN, which is,
+ *        passing the failure of a callee through.
+ *        Replaces macro "trans".
+ */
+# define EXFC_TRANS(val, rtn) EXFC_CHECK((val) != (rtn), rtn)
+
+#endif /* NO EXFC_CHECK_H */
@@ -0,0 +1,95 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_emerg.h
+ * @brief Emergency path for OutOfMemoryException & BufferOverflowException.
+ *        Both are thrown exactly when allocating or growing anything may
+ *        fail, so THROW reports them from static records through a static
+ *        buffer and write(2), never through stdio or malloc. A reserve of
+ *        heap made by exfc_emerg_init is given back on the first
+ *        OutOfMemoryException, leaving room to whatever catches it.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_EMERG_H
+# define EXFC_EMERG_H
+
+# include <stdbool.h>
+# include <stddef.h>
+
+# include "exfc.h"
+
+# ifndef EXFC_EMERG_BUFF_MAX
+#  define EXFC_EMERG_BUFF_MAX 1024
+# endif /* NO EXFC_EMERG_BUFF_MAX */
+
+/* Heap reserved by PROGBEGIN. */
+# ifndef EXFC_EMERG_RESERVE
+#  define EXFC_EMERG_RESERVE 65536
+# endif /* NO EXFC_EMERG_RESERVE */
+
+/* Static records, to be thrown without building one. */
+extern _excep_t exfc_emerg_oom;
+extern _excep_t exfc_emerg_overflow;
+
+/**
+ * @brief Put SIZE bytes of heap aside, to be freed on OutOfMemoryException.
+ * @param size Bytes to reserve; 0 reserves none.
+ * @return @b NORMAL     once reserved;\n
+ * @return @b DUPLICATED once a reserve was already held;\n
+ * @return @b ABNORMAL   once allocating failed;
+ */
+int
+exfc_emerg_init(size_t size);
+
+/**
+ * @brief Whether a heap reserve is still held.
+ */
+bool
+exfc_emerg_reserved();
+
+/**
+ * @brief Whether EXCEPT takes the emergency path.
+ */
+static inline bool
+_exfc_emerg_is(const _excep_t *except)
+{
+  return (except->_id == OutOfMemoryException
+          || except->_id == BufferOverflowException);
+}
+
+/**
+ * @brief Give the heap reserve back once EXCEPT was OutOfMemoryException.
+ *        Called by _exfc_throw.
+ */
+void
+_exfc_emerg_enter(const _excep_t *except);
+
+/**
+ * @brief Report EXCEPT and the causes of current thread to stderr without
+ *        stdio or allocating, in the text of EXCEPT_FMT & CAUSE_FMT.
+ *        Called by _exfc_throw.
+ */
+void
+_exfc_emerg_report(const _excep_t *except, const char *file, long int line,
+                   const char *function);
+
+# define THROW_OOM()                                                         \
+  THROW(&exfc_emerg_oom, __FILE__, __LINE__, __FUNCTION__, NULL)
+
+#endif /* NO EXFC_EMERG_H */
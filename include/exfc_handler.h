@@ -0,0 +1,132 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_handler.h
+ * @brief Per-exception handlers. THROW looks the handler of an exception up
+ *        in a flat array indexed by ID and calls it; the policy it returns
+ *        decides what THROW does next.
+ *
+ *        A handler may be set while other threads throw: every handler is
+ *        an immutable record published through one atomic pointer, so a
+ *        THROW sees either the former $fn & $data or the new ones, never
+ *        a mix.
+ *
+ *        Only THROW dispatches to handlers. Exceptions raised from
+ *        signals by exfc_signal skip them, see exfc_signal.h.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_HANDLER_H
+# define EXFC_HANDLER_H
+
+# include "exfc.h"
+
+/* IDs from 0 up to EXFC_HANDLER_ID_MAX - 1 can have handlers. */
+# ifndef EXFC_HANDLER_ID_MAX
+#  define EXFC_HANDLER_ID_MAX 4096
+# endif /* NO EXFC_HANDLER_ID_MAX */
+
+/**
+ * @enum What THROW does after the handler returned.
+ */
+typedef enum _exfc_policy_E
+{
+  /* Go on as without handler: catch context, or report & exit. */
+  EXFC_POLICY_DEFAULT = 0,
+  /* Report to stderr, then return from THROW. */
+  EXFC_POLICY_LOG,
+  /* Return from THROW with EXFC_POLICY_RETRY, for the caller to retry. */
+  EXFC_POLICY_RETRY,
+  /* Report to stderr, then abort(). */
+  EXFC_POLICY_ABORT,
+  /* Return from THROW silently. */
+  EXFC_POLICY_IGNORE
+} exfc_policy;
+
+typedef exfc_policy (*exfc_handler_fn)(const _excep_t *except,
+                                       const char *file, long int line,
+                                       const char *function, void *data);
+
+typedef struct _exfc_handler_S
+{
+  exfc_handler_fn _fn;
+  void *_data;
+} exfc_handler;
+
+/* Records are never freed once replaced: a THROW may still be reading
+   them. */
+extern const exfc_handler *_exfc_handlers[EXFC_HANDLER_ID_MAX];
+
+/**
+ * @brief Attach FN to the exception with ID, replacing any former handler.
+ * @param id ID of the exception.
+ * @param fn The handler; NULL detaches.
+ * @param data Passed to $fn on every call.
+ * @return @b NORMAL   once attached;\n
+ * @return @b FAILED   once $id was out of [0, EXFC_HANDLER_ID_MAX);\n
+ * @return @b ABNORMAL once allocating the record failed;
+ */
+int
+exfc_handler_set(int id, exfc_handler_fn fn, void *data);
+
+/**
+ * @brief Attach FN to the exception with ID ROOT and to every exception
+ *        descending from it, following a parent table such as the ones
+ *        tools/exfcgen generates.
+ * @param root ID of the root of the subtree.
+ * @param table Exceptions.
+ * @param parent Index in $table of the parent of every exception, -1 for
+ *               roots.
+ * @param len Length of $table & $parent.
+ * @param fn The handler; NULL detaches.
+ * @param data Passed to $fn on every call.
+ * @note Fails once $table or $parent was null.
+ * @return Amount of exceptions $fn was attached to;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_handler_set_subtree(int root, const _excep_t *table, const int *parent,
+                         int len, exfc_handler_fn fn, void *data);
+
+/**
+ * @brief Call the handler of EXCEPT, once it had one.
+ * @return What the handler returned;\n
+ * @return @b EXFC_POLICY_DEFAULT once there was no handler.
+ */
+static inline exfc_policy
+_exfc_handler_dispatch(const _excep_t *except, const char *file,
+                       long int line, const char *function)
+{
+  const unsigned int id = (unsigned int)except->_id;
+
+  if (id >= EXFC_HANDLER_ID_MAX)
+    {
+      return EXFC_POLICY_DEFAULT;
+    }
+
+  const exfc_handler *h = __atomic_load_n(&_exfc_handlers[id],
+                                          __ATOMIC_ACQUIRE);
+  if (h == NULL)
+    {
+      return EXFC_POLICY_DEFAULT;
+    }
+
+  return h->_fn(except, file, line, function, h->_data);
+}
+
+#endif /* NO EXFC_HANDLER_H */
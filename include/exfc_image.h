@@ -0,0 +1,170 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_image.h
+ * @brief Precompiled registry images. A fully built $_excep_arr can be saved
+ *        into a position-independent file, which later processes map
+ *        read-only and query directly, without re-registering anything.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_IMAGE_H
+# define EXFC_IMAGE_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "exfc.h"
+
+/* "EXFC" in little-endian. */
+# define EXFC_IMAGE_MAGIC 0x43465845u
+# define EXFC_IMAGE_VERSION 1u
+
+/*
+   Image layout (every offset is relative to the beginning of the image):
+
+   [exfc_image_hdr][exfc_image_ent * count][uint32_t byid * count]
+   [uint32_t bucket * nbucket][string table]
+
+   $byid holds entry indexes sorted by ID, for binary searching.
+   $bucket is an open-addressing name hash table, holding (entry index + 1),
+   with 0 standing for an empty bucket.
+   Every string in the string table ends with '\0', so they are usable
+   directly from the mapping.
+*/
+
+typedef struct _exfc_image_hdr_S
+{
+  uint32_t _magic;
+  uint32_t _version;
+  uint32_t _count;
+  uint32_t _nbucket;
+  uint32_t _ent_off;
+  uint32_t _byid_off;
+  uint32_t _bucket_off;
+  uint32_t _str_off;
+  uint32_t _str_len;
+  uint32_t _size;
+} exfc_image_hdr;
+
+typedef struct _exfc_image_ent_S
+{
+  uint32_t _name_off;
+  uint32_t _name_len;
+  uint32_t _desc_off;
+  uint32_t _hash;
+  int32_t _id;
+} exfc_image_ent;
+
+/**
+ * \struct exfc_image include/exfc_image.h exfc_image.h
+ * A mapped registry image. Every pointer points into the read-only mapping.
+ */
+typedef struct _exfc_image_S
+{
+  const void *_base;
+  size_t _size;
+  const exfc_image_hdr *_hdr;
+  const exfc_image_ent *_ent;
+  const uint32_t *_byid;
+  const uint32_t *_bucket;
+  const char *_str;
+} exfc_image;
+
+/**
+ * @brief Serialise every exception currently in $_excep_arr into an image
+ *        file at PATH. The file is written aside and renamed in place, so
+ *        processes mapping the old image are never disturbed.
+ * @param path Path to the image file.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL   once the image was written;\n
+ * @return @b FAILED   once failed passing through macro "fail";\n
+ * @return @b ABNORMAL once writing failed;
+ */
+int
+exfc_image_save(const char *path);
+
+/**
+ * @brief Map the image file at PATH read-only into IMG. Every entry and
+ *        bucket is checked once here, so lookups never leave the mapping.
+ * @param path Path to the image file.
+ * @param img The image to be filled.
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL      once the image was mapped;\n
+ * @return @b CONDITIONAL once the file was not a valid image, or was
+ *                          truncated or corrupted;\n
+ * @return @b FAILED      once failed passing through macro "fail";\n
+ * @return @b ABNORMAL    once opening or mapping failed;
+ */
+int
+exfc_image_load(const char *path, exfc_image *img);
+
+/**
+ * @brief Unmap IMG. IMG becomes empty afterwards.
+ * @param img The image to be unmapped.
+ */
+void
+exfc_image_unload(exfc_image *img);
+
+/**
+ * @brief Find desired exception in IMG with its name.
+ * @param img The image to be searched.
+ * @param name The name used to search for desired exception.
+ * @note Fails once any given parameter was null.
+ * @return Index of the entry being found;\n
+ * @return @b MISSING once NOT found;\n
+ * @return @b FAILED  once failed passing through macro "fail";
+ */
+int
+exfc_image_getindex_byname(const exfc_image *img, const char *name);
+
+/**
+ * @brief Find desired exception in IMG with its ID.
+ * @param img The image to be searched.
+ * @param id The ID used to search for desired exception.
+ * @note Fails once any given parameter was null, except $id.
+ * @return Index of the entry being found;\n
+ * @return @b MISSING once NOT found;\n
+ * @return @b FAILED  once failed passing through macro "fail";
+ */
+int
+exfc_image_getindex_byid(const exfc_image *img, int id);
+
+/**
+ * @brief Read the entry at IDX of IMG into an exception.
+ * @param img The image to be read.
+ * @param idx Index returned by exfc_image_getindex_by*.
+ * @return The exception, whose strings point into the mapping;\n
+ * @return @b excep_null once $idx was out of range;
+ */
+static inline _excep_t
+exfc_image_get(const exfc_image *img, int idx)
+{
+  if (img == NULL || img->_hdr == NULL || idx < 0
+      || (uint32_t)idx >= img->_hdr->_count)
+    {
+      return excep_null;
+    }
+
+  const exfc_image_ent *ent = &img->_ent[idx];
+
+  return ((_excep_t){(char *)&img->_str[ent->_name_off],
+                     (char *)&img->_str[ent->_desc_off], ent->_id});
+}
+
+#endif /* NO EXFC_IMAGE_H */
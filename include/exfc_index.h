@@ -0,0 +1,86 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_index.h
+ * @brief Sorted secondary indexes over $_excep_arr, by name and by ID.
+ *        exfc_addexcep & exfc_removeexcep_by* keep them up to date; prefix
+ *        and range queries binary search them, costing O(log n) plus the
+ *        size of the output.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_INDEX_H
+# define EXFC_INDEX_H
+
+# include "exfc.h"
+
+/**
+ * \struct exfc_index_ent include/exfc_index.h exfc_index.h
+ */
+typedef struct _exfc_index_ent_S
+{
+  const char *_name;
+  unsigned int _len;
+  int _id;
+} exfc_index_ent;
+
+/**
+ * @brief Add NAME of length LEN with ID to both indexes.
+ * @note Fails once $name was null.
+ * @return @b NORMAL      once added;\n
+ * @return @b DUPLICATED  once $id was already indexed;\n
+ * @return @b CONDITIONAL once the indexes were full;\n
+ * @return @b FAILED      once failed passing through macro "fail";
+ */
+int
+_exfc_index_insert(const char *name, unsigned int len, int id);
+
+/**
+ * @brief Remove the exception with ID from both indexes.
+ * @return @b NORMAL  once removed;\n
+ * @return @b MISSING once $id was not indexed;
+ */
+int
+_exfc_index_remove(int id);
+
+/**
+ * @brief Find every exception whose name begins with PREFIX, in name order.
+ * @param prefix The prefix to be matched; "" matches every exception.
+ * @param out Where matched entries are written.
+ * @param max Capacity of $out.
+ * @note Fails once any given pointer was null.
+ * @return Amount of entries written into $out;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_index_prefix(const char *prefix, exfc_index_ent *out, int max);
+
+/**
+ * @brief Find every exception whose ID lies in [LO, HI], in ID order.
+ * @param lo The lowest ID to be matched.
+ * @param hi The highest ID to be matched.
+ * @param out Where matched entries are written.
+ * @param max Capacity of $out.
+ * @note Fails once any given pointer was null.
+ * @return Amount of entries written into $out;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_index_range(int lo, int hi, exfc_index_ent *out, int max);
+
+#endif /* NO EXFC_INDEX_H */
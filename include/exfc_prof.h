@@ -0,0 +1,120 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_prof.h
+ * @brief Throw-site profiler. While running, one THROW out of every
+ *        $rate on each thread captures its call stack and counts it in a
+ *        lock-free table keyed by the hash of the stack. exfc_prof_dump
+ *        writes the counts as folded stacks, one line per distinct stack:
+ *
+ *        main;parse;read_field;OutOfBoundException 42
+ *
+ *        which flamegraph.pl and compatible tools accept as is.
+ * @note Function names come from backtrace_symbols(3); link with -rdynamic
+ *       to get them, otherwise frames show as addresses.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_PROF_H
+# define EXFC_PROF_H
+
+# include <stdio.h>
+
+# include "exfc.h"
+
+/* Distinct stacks kept, power of 2. Stacks beyond it are counted as lost. */
+# ifndef EXFC_PROF_SLOT_MAX
+#  define EXFC_PROF_SLOT_MAX 4096
+# endif /* NO EXFC_PROF_SLOT_MAX */
+
+/* Frames kept per stack, innermost first. */
+# ifndef EXFC_PROF_DEPTH_MAX
+#  define EXFC_PROF_DEPTH_MAX 32
+# endif /* NO EXFC_PROF_DEPTH_MAX */
+
+/* Sampling rate; 0 while stopped. Read by THROW on every call. */
+extern unsigned int _exfc_prof_rate;
+
+/**
+ * @brief Start profiling, sampling one THROW out of every RATE per thread.
+ *        Counts from a former run are kept; see exfc_prof_reset.
+ * @param rate 1 samples every THROW.
+ * @return @b NORMAL once started, or the rate changed;\n
+ * @return @b FAILED once $rate was 0;
+ */
+int
+exfc_prof_start(unsigned int rate);
+
+/**
+ * @brief Stop sampling. Counts are kept for exfc_prof_dump.
+ */
+void
+exfc_prof_stop();
+
+/**
+ * @brief Drop every count. Only while stopped.
+ * @note A THROW which was sampling as the profiler stopped may still add
+ *       to a slot being dropped, and leave a stray count or a slot that
+ *       exfc_prof_dump skips. Reset once such throws returned, for every
+ *       count to start from 0.
+ * @return @b NORMAL   once dropped;\n
+ * @return @b ABNORMAL once still running;
+ */
+int
+exfc_prof_reset();
+
+/**
+ * @brief Write every stack counted so far as folded stacks, outermost
+ *        frame first, the exception thrown as the last frame.
+ * @param stream Where to write.
+ * @note Fails once any given parameter was null.
+ * @return Amount of lines written;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_prof_dump(FILE *stream);
+
+/**
+ * @brief Return how many samples found the table full.
+ */
+unsigned long int
+exfc_prof_lost();
+
+/**
+ * @brief Capture & count the stack of current THROW. Called by _exfc_throw.
+ * @param function The function throwing, as THROW was given.
+ */
+EXFC_COLD void
+_exfc_prof_sample(const _excep_t *except, const char *function);
+
+/**
+ * @brief Count one THROW, sampling it once its turn came. The not-running
+ *        path is one load & one branch.
+ */
+__attribute__((always_inline)) static inline void
+_exfc_prof_tick(const _excep_t *except, const char *function)
+{
+  if (EXFC_LIKELY(__atomic_load_n(&_exfc_prof_rate, __ATOMIC_RELAXED) == 0))
+    {
+      return;
+    }
+
+  _exfc_prof_sample(except, function);
+}
+
+#endif /* NO EXFC_PROF_H */
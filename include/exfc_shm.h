@@ -0,0 +1,171 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_shm.h
+ * @brief Live registry in POSIX shared memory. Every process attached to the
+ *        same region sees one consistent set of exceptions.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_SHM_H
+# define EXFC_SHM_H
+
+# include <pthread.h>
+# include <stdint.h>
+
+# include "exfc.h"
+
+/* "ESHM" in little-endian. */
+# define EXFC_SHM_MAGIC 0x4D485345u
+# define EXFC_SHM_VERSION 2u
+
+# ifndef EXFC_SHM_ENTRY_MAX
+#  define EXFC_SHM_ENTRY_MAX EXCEP_ARRAY_MAX
+# endif /* NO EXFC_SHM_ENTRY_MAX */
+
+# ifndef EXFC_SHM_STR_MAX
+#  define EXFC_SHM_STR_MAX 262144
+# endif /* NO EXFC_SHM_STR_MAX */
+
+/* Spins a reader waits on one unfinished write before taking $_lock. */
+# ifndef EXFC_SHM_READ_SPIN
+#  define EXFC_SHM_READ_SPIN 1024
+# endif /* NO EXFC_SHM_READ_SPIN */
+
+/*
+   Strings are stored by offset into $_str, never by pointer, since every
+   process maps the region at its own address. Strings are appended; once
+   the end of $_str is reached, the bytes of removed entries are reused.
+   The strings of an entry never change while it is in the registry, but
+   may be overwritten once it was removed, so readers compare them only
+   between checks of $_seq.
+
+   Writers serialise on $_lock, a robust process-shared mutex: a process
+   dying while holding it leaves it to the next writer, which repairs what
+   was left half-written. Readers follow $_seq, which is odd while a writer
+   is modifying $_ent, and retry on any change. A reader seeing one write
+   go on for EXFC_SHM_READ_SPIN spins takes $_lock itself, so a writer
+   that died halfway gets repaired without waiting for another writer.
+*/
+
+typedef struct _exfc_shm_ent_S
+{
+  uint32_t _used;
+  uint32_t _name_off;
+  uint32_t _name_len;
+  uint32_t _desc_off;
+  uint32_t _desc_len;
+  int32_t _id;
+} exfc_shm_ent;
+
+typedef struct _exfc_shm_region_S
+{
+  uint32_t _magic;
+  uint32_t _version;
+  pthread_mutex_t _lock;
+  uint32_t _seq;
+  uint32_t _str_used;
+  exfc_shm_ent _ent[EXFC_SHM_ENTRY_MAX];
+  char _str[EXFC_SHM_STR_MAX];
+} exfc_shm_region;
+
+/**
+ * @brief Attach to the shared registry called NAME, creating it once it did
+ *        not exist.
+ * @param name Name of the shared memory object, such as "/exfc".
+ * @note Fails once any given parameter was null.
+ * @return @b NORMAL      once attached;\n
+ * @return @b DUPLICATED  once already attached;\n
+ * @return @b CONDITIONAL once the object existed but was not a registry;\n
+ * @return @b FAILED      once failed passing through macro "fail";\n
+ * @return @b ABNORMAL    once opening, mapping or creating the lock failed;
+ */
+int
+exfc_shm_attach(const char *name);
+
+/**
+ * @brief Detach from the shared registry. Exceptions read out of it before
+ *        become invalid.
+ */
+void
+exfc_shm_detach();
+
+/**
+ * @brief Remove the shared memory object called NAME. Attached processes
+ *        keep their mappings.
+ * @param name Name of the shared memory object.
+ * @return @b NORMAL once removed;\n
+ * @return @b FAILED once failed passing through macro "fail";\n
+ * @return @b ABNORMAL once removing failed;
+ */
+int
+exfc_shm_unlink(const char *name);
+
+/**
+ * @brief Same as exfc_addexcep, on the shared registry.
+ * @return Index to the exception being added;\n
+ * @return @b CONDITIONAL once the registry was full, or out of strings;\n
+ * @return @b DUPLICATED  once the registry had a same element;\n
+ * @return @b FAILED      once failed passing through macro "fail", or
+ *                        $name or $description was longer than
+ *                        EXCEP_BUFF_MAX;\n
+ * @return @b ABNORMAL    once NOT attached, or the lock was lost;
+ * @exception BufferOverflowException
+ */
+int
+exfc_shm_addexcep(const char *name, const char *description, int id);
+
+/**
+ * @brief Same as exfc_removeexcep_byid, on the shared registry.
+ * @return Index to the exception being removed;\n
+ * @return @b MISSING  once the registry had no desired exception;\n
+ * @return @b ABNORMAL once NOT attached, or the lock was lost;
+ */
+int
+exfc_shm_removeexcep_byid(int id);
+
+/**
+ * @brief Same as exfc_getindex_byname, on the shared registry.
+ * @return Index of the exception being found;\n
+ * @return @b MISSING  once NOT found;\n
+ * @return @b FAILED   once failed passing through macro "fail";\n
+ * @return @b ABNORMAL once NOT attached;
+ */
+int
+exfc_shm_getindex_byname(const char *name);
+
+/**
+ * @brief Same as exfc_getindex_byid, on the shared registry.
+ * @return Index of the exception being found;\n
+ * @return @b MISSING  once NOT found;\n
+ * @return @b ABNORMAL once NOT attached;
+ */
+int
+exfc_shm_getindex_byid(int id);
+
+/**
+ * @brief Read the exception at IDX of the shared registry.
+ * @param idx Index returned by exfc_shm_getindex_by*.
+ * @return The exception, whose strings point into this process's mapping
+ *         and stay valid until it is removed;\n
+ * @return @b excep_null once $idx was empty or out of range.
+ */
+_excep_t
+exfc_shm_get(int idx);
+
+#endif /* NO EXFC_SHM_H */
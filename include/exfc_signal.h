@@ -0,0 +1,101 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_signal.h
+ * @brief Opt-in conversion of SIGSEGV, SIGBUS & SIGFPE into exceptions.
+ *        SIGSEGV & SIGBUS raise IllegalMemoryAccessException, SIGFPE raises
+ *        ArithmeticException. The exception goes to the innermost catch
+ *        context of the faulting thread; without one, it is reported to
+ *        stderr and the process exits with the ID of the exception.
+ *
+ *        Handlers set with exfc_handler_set are NOT consulted for these
+ *        exceptions: a handler need not be async-signal-safe, and
+ *        returning from the fault, as IGNORE, RETRY & LOG would, runs the
+ *        faulting instruction again. Catch them with EXFC_TRY instead.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_SIGNAL_H
+# define EXFC_SIGNAL_H
+
+# include <stdbool.h>
+
+# include "exfc_catch.h"
+
+# ifndef EXFC_SIGNAL_STACK_SIZE
+#  define EXFC_SIGNAL_STACK_SIZE 65536
+# endif /* NO EXFC_SIGNAL_STACK_SIZE */
+
+# ifndef EXFC_SIGNAL_BUFF_MAX
+#  define EXFC_SIGNAL_BUFF_MAX 512
+# endif /* NO EXFC_SIGNAL_BUFF_MAX */
+
+/**
+ * @brief Tell where the memory at ADDR came from. Called from the fault
+ *        handler, so it must be async-signal-safe.
+ * @param addr The faulting address.
+ * @param file, line, function Receive the allocation site.
+ * @param what Receives what went wrong, such as "Use after free".
+ * @return Whether $addr was known.
+ */
+typedef bool (*exfc_signal_site_fn)(void *addr, const char **file,
+                                    long int *line, const char **function,
+                                    const char **what);
+
+/**
+ * @brief Install the fault handlers for the whole process, and an alternate
+ *        signal stack for the calling thread, so stack overflows can still
+ *        be reported.
+ * @return @b NORMAL     once installed;\n
+ * @return @b DUPLICATED once already installed;\n
+ * @return @b ABNORMAL   once sigaltstack or sigaction failed;
+ */
+int
+exfc_signal_install();
+
+/**
+ * @brief Give the calling thread its own alternate signal stack. Every
+ *        thread other than the one calling exfc_signal_install needs it
+ *        before its stack overflows can be reported. The stack is freed
+ *        as the thread exits.
+ * @return @b NORMAL     once done;\n
+ * @return @b DUPLICATED once the thread already had one;\n
+ * @return @b ABNORMAL   once allocating or sigaltstack failed;
+ */
+int
+exfc_signal_thread_init();
+
+/**
+ * @brief Restore the handlers which were in place before
+ *        exfc_signal_install.
+ * @return @b NORMAL  once restored;\n
+ * @return @b MISSING once NOT installed;
+ */
+int
+exfc_signal_uninstall();
+
+/**
+ * @brief Let FN name the allocation site of faulting addresses. A known
+ *        site is reported, and put into the catch context as $_file,
+ *        $_line & $_function.
+ * @param fn The lookup; NULL removes it.
+ */
+void
+exfc_signal_set_site(exfc_signal_site_fn fn);
+
+#endif /* NO EXFC_SIGNAL_H */
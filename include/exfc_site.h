@@ -0,0 +1,161 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_site.h
+ * @brief THROW by ID or by name, with the lookup cached per throw site.
+ *        Every THROW_BYID & THROW_BYNAME owns a static cache holding the
+ *        index its exception was found at, and the registry generation it
+ *        was found in. Every change to the registry bumps the generation,
+ *        so a repeated throw skips the lookup until the registry changed.
+ *        A cached entry is used only while its ID (or name) still matches
+ *        what the site throws; otherwise the site looks it up again.
+ * @note THROW_BYID & THROW_BYNAME use GNU statement expressions.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_SITE_H
+# define EXFC_SITE_H
+
+# include <stdint.h>
+# include <string.h>
+
+# include "exfc.h"
+
+/* Bumped by every change to $_excep_arr. */
+extern unsigned int _exfc_registry_gen;
+
+/**
+ * \struct exfc_site_cache include/exfc_site.h exfc_site.h
+ * Generation in the upper 32 bits, index + 1 in the lower; 0 while
+ * unresolved. One word, so concurrent throws never see a torn entry.
+ */
+typedef struct _exfc_site_cache_S
+{
+  uint64_t _word;
+} exfc_site_cache;
+
+/**
+ * @brief Mark every cached lookup stale. Called by whatever changes
+ *        $_excep_arr.
+ */
+static inline void
+_exfc_registry_bump()
+{
+  (void)__atomic_add_fetch(&_exfc_registry_gen, 1u, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Look ID up and store the result into CACHE. Cold.
+ * @return The exception;\n
+ * @return NULL once NOT registered;
+ */
+EXFC_COLD const _excep_t *
+_exfc_site_resolve_byid(exfc_site_cache *cache, int id);
+
+/**
+ * @brief Look NAME up and store the result into CACHE. Cold.
+ * @return The exception;\n
+ * @return NULL once NOT registered;
+ */
+EXFC_COLD const _excep_t *
+_exfc_site_resolve_byname(exfc_site_cache *cache, const char *name);
+
+/**
+ * @brief Throw UnknownException for a site whose exception is not
+ *        registered. Cold.
+ * @return Same as _exfc_throw.
+ */
+EXFC_COLD int
+_exfc_site_throw_missing(const char *file, long int line,
+                         const char *function);
+
+/**
+ * @brief Exception cached in CACHE, or NULL once it was resolved in an
+ *        older generation, or never.
+ */
+__attribute__((always_inline)) static inline const _excep_t *
+_exfc_site_lookup(const exfc_site_cache *cache)
+{
+  const uint64_t word = __atomic_load_n(&cache->_word, __ATOMIC_RELAXED);
+  const unsigned int gen = __atomic_load_n(&_exfc_registry_gen,
+                                           __ATOMIC_ACQUIRE);
+
+  if (EXFC_UNLIKELY((uint32_t)word == 0
+                    || (unsigned int)(word >> 32) != gen))
+    {
+      return NULL;
+    }
+
+  return _exfc_getexcep((int)(uint32_t)word - 1);
+}
+
+/* Whether a cached E is still the one called NAME. */
+__attribute__((always_inline)) static inline bool
+_exfc_site_named(const _excep_t *e, const char *name)
+{
+  return (e->_name != NULL && name != NULL && strcmp(e->_name, name) == 0);
+}
+
+__attribute__((always_inline)) static inline int
+_exfc_site_throw(const _excep_t *except, const char *file, long int line,
+                 const char *function)
+{
+  if (EXFC_UNLIKELY(except == NULL))
+    {
+      return _exfc_site_throw_missing(file, line, function);
+    }
+
+  return _exfc_throw((_excep_t *)except, file, line, function, NULL);
+}
+
+/**
+ * @brief Throw the registered exception with ID.
+ * @return Same as THROW.
+ */
+# define THROW_BYID(id)                                                      \
+  ({                                                                        \
+    static exfc_site_cache _exfc_site_c = {0};                              \
+    const int _exfc_site_id = (id);                                         \
+    const _excep_t *_exfc_site_e = _exfc_site_lookup(&_exfc_site_c);        \
+    if (_exfc_site_e == NULL || _exfc_site_e->_id != _exfc_site_id)         \
+      {                                                                     \
+        _exfc_site_e = _exfc_site_resolve_byid(&_exfc_site_c,               \
+                                               _exfc_site_id);              \
+      }                                                                     \
+    _exfc_site_throw(_exfc_site_e, __FILE__, __LINE__, __FUNCTION__);       \
+  })
+
+/**
+ * @brief Throw the registered exception called NAME.
+ * @return Same as THROW.
+ */
+# define THROW_BYNAME(name)                                                  \
+  ({                                                                        \
+    static exfc_site_cache _exfc_site_c = {0};                              \
+    const char *_exfc_site_n = (name);                                      \
+    const _excep_t *_exfc_site_e = _exfc_site_lookup(&_exfc_site_c);        \
+    if (_exfc_site_e == NULL || !_exfc_site_named(_exfc_site_e,             \
+                                                  _exfc_site_n))            \
+      {                                                                     \
+        _exfc_site_e = _exfc_site_resolve_byname(&_exfc_site_c,             \
+                                                 _exfc_site_n);             \
+      }                                                                     \
+    _exfc_site_throw(_exfc_site_e, __FILE__, __LINE__, __FUNCTION__);       \
+  })
+
+#endif /* NO EXFC_SITE_H */
@@ -0,0 +1,151 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_task.h
+ * @brief Cross-thread exception propagation. A task runs on a worker
+ *        thread under a catch context; whatever it throws is moved into the
+ *        task, together with its causes and payload, and thrown again in the
+ *        thread joining the task. The catch context there gets the
+ *        payload as $_payload & $_payload_len.
+ *
+ *        Worker:  exfc_task_run(&task);
+ *        Joiner:  exfc_task_wait(&task);
+ *                 rtn = exfc_task_join(&task);   (throws once task threw)
+ *
+ *        The worker publishes the outcome with one atomic release store; no
+ *        lock is taken.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_TASK_H
+# define EXFC_TASK_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# include "exfc_chain.h"
+
+/* Causes kept per task. */
+# ifndef EXFC_TASK_CAUSE_MAX
+#  define EXFC_TASK_CAUSE_MAX 8
+# endif /* NO EXFC_TASK_CAUSE_MAX */
+
+/* Bytes of payload kept per task. */
+# ifndef EXFC_TASK_PAYLOAD_MAX
+#  define EXFC_TASK_PAYLOAD_MAX 256
+# endif /* NO EXFC_TASK_PAYLOAD_MAX */
+
+# define EXFC_TASK_PENDING 0u
+# define EXFC_TASK_DONE 1u
+# define EXFC_TASK_THROWN 2u
+
+typedef int (*exfc_task_fn)(void *arg);
+
+/**
+ * \struct exfc_task include/exfc_task.h exfc_task.h
+ */
+typedef struct _exfc_task_S
+{
+  exfc_task_fn _fn;
+  void *_arg;
+  /* What $_fn returned, once EXFC_TASK_DONE. */
+  int _rtn;
+  /* Written by the worker only; read by the joiner after $_state. */
+  _excep_t _except;
+  const char *_file;
+  const char *_function;
+  long int _line;
+  /* Causes, newest first. */
+  exfc_cause _cause[EXFC_TASK_CAUSE_MAX];
+  unsigned int _cause_len;
+  /* Attached to $_except; emptied once $_fn returned. */
+  unsigned char _payload[EXFC_TASK_PAYLOAD_MAX];
+  size_t _payload_len;
+  /* EXFC_TASK_PENDING, EXFC_TASK_DONE or EXFC_TASK_THROWN */
+  uint32_t _state;
+} exfc_task;
+
+/**
+ * @brief Prepare TASK to run FN with ARG.
+ * @note Fails once $task or $fn was null.
+ * @return @b NORMAL once prepared;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_task_init(exfc_task *task, exfc_task_fn fn, void *arg);
+
+/**
+ * @brief Run TASK on the calling thread, catching anything it throws.
+ *        Never exits because of an exception.
+ * @note Fails once any given parameter was null.
+ * @return @b EXFC_TASK_DONE or @b EXFC_TASK_THROWN;\n
+ * @return @b FAILED once failed passing through macro "fail";
+ */
+int
+exfc_task_run(exfc_task *task);
+
+/**
+ * @brief Attach LEN bytes at DATA to the exception about to be thrown by
+ *        the task running on the calling thread. Bytes beyond
+ *        EXFC_TASK_PAYLOAD_MAX are dropped. Dropped too once the task
+ *        returns without throwing.
+ * @return @b NORMAL  once attached;\n
+ * @return @b MISSING once no task was running on the calling thread;
+ */
+int
+exfc_task_payload(const void *data, size_t len);
+
+/**
+ * @brief Return the state of TASK.
+ */
+static inline uint32_t
+exfc_task_state(const exfc_task *task)
+{
+  return __atomic_load_n(&task->_state, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Wait, yielding, until TASK is no longer pending.
+ * @return @b EXFC_TASK_DONE or @b EXFC_TASK_THROWN.
+ */
+uint32_t
+exfc_task_wait(const exfc_task *task);
+
+/**
+ * @brief Collect the outcome of TASK on the calling thread. Once TASK
+ *        threw, its exception is thrown again here, with its causes; the
+ *        catch context receiving it points at the payload of $task.
+ * @note Fails once any given parameter was null.
+ * @return What the function of $task returned;\n
+ * @return @b CONDITIONAL once $task was still pending;\n
+ * @return @b ABNORMAL    once $task threw, and a handler let THROW return;\n
+ * @return @b FAILED      once failed passing through macro "fail";
+ */
+int
+exfc_task_join(exfc_task *task);
+
+/**
+ * @brief The payload exfc_task_join hands to the throw in progress.
+ *        Consumed by _exfc_throw.
+ * @param data Receives the payload, or NULL.
+ * @return Its length; 0 once there was none.
+ */
+size_t
+_exfc_task_take_payload(const void **data);
+
+#endif /* NO EXFC_TASK_H */
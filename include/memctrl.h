@@ -2,31 +2,154 @@
 # define MEMCTRL_H 1
 
 # include <stdbool.h>
+# include <stddef.h>
+# include <stdint.h>
+# include <stdio.h>
 # include <string.h>
 
 # define MAX_MEMCTRL_STACK 65536
 
-static void *MEMCTRL_STACK[MAX_MEMCTRL_STACK] = {0};
+/* Distinct allocation sites remembered, power of 2, at most 65536.
+   Allocations from sites beyond it are reported under the unknown site. */
+# ifndef MAX_MEMCTRL_SITE
+#  define MAX_MEMCTRL_SITE 1024
+# endif /* NO MAX_MEMCTRL_SITE */
+
+/* Guarded slots; each takes one page of data & one guard page. */
+# ifndef MAX_MEMCTRL_GUARD
+#  define MAX_MEMCTRL_GUARD 256
+# endif /* NO MAX_MEMCTRL_GUARD */
+
+/* Define it nonzero to have PROGBEGIN guard one out of every
+   MEMCTRL_GUARD_RATE allocations per thread, and install exfc_signal to
+   report the faults, see memctrl_guard_begin. Off by default: guarded
+   memory must only be released through memctrl_free & memctrl_realloc. */
+# ifndef MEMCTRL_GUARD_RATE
+#  define MEMCTRL_GUARD_RATE 0
+# endif /* NO MEMCTRL_GUARD_RATE */
+
+/* Least alignment of guarded allocations, a power of 2. Guarded memory is
+   aligned to the largest power of 2 dividing its size, at most 16 as
+   malloc's, which suits any object of that size. At 1 it thus ends exactly
+   at the guard page, and overflowing it by a single byte faults, but a
+   buffer whose size is not a multiple of 16 may come out less aligned than
+   from malloc. Raising it trades up to MEMCTRL_GUARD_ALIGN - 1 unguarded
+   bytes past the end for that alignment. */
+# ifndef MEMCTRL_GUARD_ALIGN
+#  define MEMCTRL_GUARD_ALIGN 1
+# endif /* NO MEMCTRL_GUARD_ALIGN */
+
+/**
+ * \struct memctrl_site include/memctrl.h memctrl.h
+ * Where tracked memory was allocated. Site 0 is the unknown site.
+ */
+typedef struct _memctrl_site_S
+{
+  const char *_file;
+  const char *_function;
+  long int _line;
+  /* Return address of the allocating function; NULL once not taken. */
+  void *_caller;
+} memctrl_site;
 
-bool __MEMCTRL_STATUS_LOCK = false;
+/* Every tracked pointer carries a 16-bit site index and its size in side
+   tables parallel to MEMCTRL_STACK. */
+extern void *MEMCTRL_STACK[MAX_MEMCTRL_STACK];
+extern uint16_t MEMCTRL_STACK_SITE[MAX_MEMCTRL_STACK];
+extern size_t MEMCTRL_STACK_SIZE[MAX_MEMCTRL_STACK];
 
-void **_memctrl_p;
+extern bool __MEMCTRL_STATUS_LOCK;
 
-static inline void
-memctrl_initmemstk()
-{
-  /* Lock up status */
-  __MEMCTRL_STATUS_LOCK = true;
-  
-  /* Initialise memstack */
-  memset(MEMCTRL_STACK, 0, MAX_MEMCTRL_STACK);
-}
-
-static inline void
-memctrl_resetmemstk()
-{
-  
-}
+extern void **_memctrl_p;
+
+void
+memctrl_initmemstk();
+
+/**
+ * @brief Report every pointer still tracked to stderr, grouped by
+ *        allocation site, then empty the stack.
+ */
+void
+memctrl_resetmemstk();
+
+/**
+ * @brief Write live allocations grouped by site, the most bytes first.
+ * @param stream Where to write.
+ * @return Amount of sites with live allocations;\n
+ * @return @b FAILED once $stream was null;
+ */
+int
+memctrl_report(FILE *stream);
+
+/**
+ * @brief Track ADDR, of SIZE bytes, allocated at FILE:LINE.
+ * @note THROWs OutOfBoundException once the stack was full.
+ */
+void
+_memctrl_push_site(void *addr, size_t size, const char *file, long int line,
+                   const char *function, void *caller);
+
+/**
+ * @brief Allocate SIZE bytes and track them at the given site.
+ * @return The memory;\n
+ * @return @b NULL once malloc failed and a handler let the
+ *         OutOfMemoryException thrown go on.
+ */
+void *
+_memctrl_malloc_site(size_t size, const char *file, long int line,
+                     const char *function, void *caller);
+
+/**
+ * @brief Start placing one out of every RATE memctrl_malloc calls per
+ *        thread against a PROT_NONE guard page, and making it PROT_NONE once
+ *        freed. Overflows past such an allocation and use after free then
+ *        fault; with exfc_signal installed, the fault is raised as
+ *        IllegalMemoryAccessException carrying the allocation site.
+ *        Only allocations of at most one page are guarded.
+ * @param rate 0 stops sampling; guarded memory already handed out stays.
+ * @return @b NORMAL   once started, or the rate changed;\n
+ * @return @b ABNORMAL once mapping the guarded pool failed;
+ */
+int
+memctrl_guard_init(unsigned int rate);
+
+/**
+ * @brief memctrl_guard_init, then exfc_signal_install, so that the faults
+ *        are reported as exceptions; what PROGBEGIN calls.
+ * @return @b NORMAL   once started;\n
+ * @return @b ABNORMAL once mapping the guarded pool, or installing the
+ *         handlers failed;
+ */
+int
+memctrl_guard_begin(unsigned int rate);
+
+/**
+ * @brief Whether ADDR lies in the guarded pool.
+ */
+bool
+memctrl_guarded(const void *addr);
+
+/**
+ * @brief Stop tracking ADDR and free it.
+ * @note THROWs IllegalMemoryAccessException once a guarded allocation was
+ *       freed twice.
+ * @note Guarded memory is not malloc's; handing it to free or realloc
+ *       corrupts the heap.
+ */
+void
+memctrl_free(void *addr);
+
+/**
+ * @brief Resize ADDR, from memctrl_malloc, to SIZE bytes, tracked at the
+ *        given site. Guarded memory is moved into a new allocation.
+ * @return The memory, ADDR being then released;\n
+ * @return @b NULL once SIZE was 0, ADDR being freed;\n
+ * @return @b NULL once out of memory, ADDR being left alone, and a handler
+ *         let the OutOfMemoryException thrown go on.
+ */
+void *
+_memctrl_realloc_site(void *addr, size_t size, const char *file,
+                      long int line, const char *function, void *caller);
 
 void
 memctrl_push(void *addr);
@@ -34,6 +157,13 @@ memctrl_push(void *addr);
 void
 memctrl_pop();
 
+/**
+ * @brief Stop tracking ADDR, wherever it is on the stack.
+ * @return true once it was tracked.
+ */
+bool
+memctrl_remove(void *addr);
+
 bool
 memctrl_empty();
 
@@ -52,7 +182,22 @@ _memctrl_get();
 void
 _memctrl_set(void *addr);
 
-# define PROGBEGIN memctrl_initmemstk()
+# define MEMCTRL_PUSH(addr, size)                                             \
+  _memctrl_push_site((addr), (size), __FILE__, __LINE__, __FUNCTION__,        \
+                     __builtin_return_address(0))
+
+# define memctrl_malloc(size)                                                 \
+  _memctrl_malloc_site((size), __FILE__, __LINE__, __FUNCTION__,              \
+                       __builtin_return_address(0))
+
+# define memctrl_realloc(addr, size)                                           \
+  _memctrl_realloc_site((addr), (size), __FILE__, __LINE__, __FUNCTION__,     \
+                        __builtin_return_address(0))
+
+# define PROGBEGIN                                                             \
+  (memctrl_initmemstk(),                                                      \
+   (void)((MEMCTRL_GUARD_RATE) == 0                                           \
+          || memctrl_guard_begin(MEMCTRL_GUARD_RATE)))
 # define PROGEND memctrl_resetmemstk()
 
 #endif /* NO MEMCTRL_H */
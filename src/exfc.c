@@ -19,19 +19,46 @@
  * @author William Lee
  */
 
+#include <string.h>
+
 #include "exfc.h"
+#include "exfc_emerg.h"
+#include "exfc_index.h"
+#include "exfc_site.h"
+
+_excep_t _excep_arr[EXCEP_ARRAY_MAX];
+const int _excep_arr_len = EXCEP_ARRAY_MAX;
 
 int
 exfc_cmp(_excep_t *a, _excep_t *b)
 {
-  fails(a, FAILED);
-  fails(b, FAILED);
+  EXFC_FAILS(a, FAILED);
+  EXFC_FAILS(b, FAILED);
 
   return ((a->_id > b->_id)
          ? GREATER : (a->_id == b->_id)
             ? IDENTICAL : LESS);
 }
 
+static int
+_exfc_getindex_byname_n(const char *name, unsigned long len);
+
+/* LEN must be what strlen(NAME) returns: at most EXCEP_BUFF_MAX, ending
+   $name, and with no '\0' before. */
+static int
+_exfc_name_len_chk(const char *name, unsigned long len)
+{
+  if (len > EXCEP_BUFF_MAX)
+    {
+      THROW(&exfc_emerg_overflow, __FILE__, __LINE__, __FUNCTION__, EXCEP_FMT);
+      return FAILED;
+    }
+
+  EXFC_CHECK(name[len] == '\0' && memchr(name, '\0', len) == NULL, FAILED);
+
+  return NORMAL;
+}
+
 int
 exfc_addexcep(const char *name, const char *description, int id)
 {
@@ -45,18 +72,37 @@ exfc_addexcep(const char *name, const char *description, int id)
                 _excep_arr[0]._name);
   /* TEST OVER */
 
-  fails(_excep_arr, ABNORMAL);
-  fails(name, FAILED);
-  fails(description, FAILED);
+  EXFC_FAILS(name, FAILED);
 
-  _exfc_buffersize_chk((char *)name);
-  _exfc_buffersize_chk((char *)description);
+  unsigned long len;
+  EXFC_TRANS(_exfc_buffersize_chk_n(name, &len), FAILED);
 
-  const int byname = exfc_getindex_byname(name);
-  trans(byname, FAILED);
+  return exfc_addexcep_n(name, len, description, id);
+}
+
+int
+exfc_addexcep_n(const char *name, unsigned long len, const char *description,
+                int id)
+{
+  if (id < 0)
+    {
+      return CONDITIONAL;
+    }
+
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
+  EXFC_FAILS(description, FAILED);
+
+  EXFC_TRANS(_exfc_name_len_chk(name, len), FAILED);
+
+  unsigned long desc_len;
+  EXFC_TRANS(_exfc_buffersize_chk_n(description, &desc_len), FAILED);
+
+  const int byname = _exfc_getindex_byname_n(name, len);
+  EXFC_TRANS(byname, FAILED);
 
   const int byid = exfc_getindex_byid(id);
-  trans(byid, ABNORMAL);
+  EXFC_TRANS(byid, ABNORMAL);
 
   /* Found the duplication, exit. */
   if (byname != MISSING || byid != MISSING)
@@ -77,6 +123,9 @@ exfc_addexcep(const char *name, const char *description, int id)
   _excep_arr[rearrange]._name = (char *)name;
   _excep_arr[rearrange]._description = (char *)description;
   _excep_arr[rearrange]._id = id;
+  _exfc_registry_bump();
+
+  (void)_exfc_index_insert(name, (unsigned int)len, id);
 
   return rearrange;
 }
@@ -92,18 +141,18 @@ _exfc_addexcep_test(const void *name, const void *description, int id)
 ", _name, _description, id);
   /* TEST OVER */
 
-  fails(_excep_arr, ABNORMAL);
-  fails(name, FAILED);
-  fails(description, FAILED);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
+  EXFC_FAILS(description, FAILED);
 
   _exfc_buffersize_chk((char *)name);
   _exfc_buffersize_chk((char *)description);
 
   const int byname = exfc_getindex_byname(name);
-  trans(byname, FAILED);
+  EXFC_TRANS(byname, FAILED);
 
   const int byid = exfc_getindex_byid(id);
-  trans(byid, ABNORMAL);
+  EXFC_TRANS(byid, ABNORMAL);
 
   /* Found the duplication, exit. */
   if (byname != MISSING || byid != MISSING)
@@ -124,6 +173,7 @@ _exfc_addexcep_test(const void *name, const void *description, int id)
   _excep_arr[rearrange]._name = (char *)name;
   _excep_arr[rearrange]._description = (char *)description;
   _excep_arr[rearrange]._id = id;
+  _exfc_registry_bump();
 
   return rearrange;
 
@@ -132,21 +182,36 @@ _exfc_addexcep_test(const void *name, const void *description, int id)
 int
 exfc_removeexcep_byname(const char *name)
 {
-  fails(_excep_arr, ABNORMAL);
-  fails(name, FAILED);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
 
-  _exfc_buffersize_chk((char *)name);
+  unsigned long len;
+  EXFC_TRANS(_exfc_buffersize_chk_n(name, &len), FAILED);
+
+  return exfc_removeexcep_byname_n(name, len);
+}
+
+int
+exfc_removeexcep_byname_n(const char *name, unsigned long len)
+{
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
+
+  EXFC_TRANS(_exfc_name_len_chk(name, len), FAILED);
 
   /* Find the desired exception */
-  int byname = exfc_getindex_byname(name);
+  int byname = _exfc_getindex_byname_n(name, len);
 
   /* Not found */
-  trans(byname, MISSING);
+  EXFC_TRANS(byname, MISSING);
+
+  (void)_exfc_index_remove(_excep_arr[byname]._id);
 
   /* Assign */
   _excep_arr[byname]._name = NULL;
   _excep_arr[byname]._description = NULL;
   _excep_arr[byname]._id = 0;
+  _exfc_registry_bump();
 
   return byname;
 }
@@ -159,18 +224,21 @@ exfc_removeexcep_byid(int id)
       return FAILED;
     }
 
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   /* Find the desired exception */
   int byid = exfc_getindex_byid(id);
 
   /* Not found */
-  trans(byid, MISSING);
+  EXFC_TRANS(byid, MISSING);
+
+  (void)_exfc_index_remove(id);
 
   /* Assign */
   _excep_arr[byid]._name = NULL;
   _excep_arr[byid]._description = NULL;
   _excep_arr[byid]._id = 0;
+  _exfc_registry_bump();
 
   return byid;
 }
@@ -178,7 +246,7 @@ exfc_removeexcep_byid(int id)
 _excep_t *
 exfc_getallexcep()
 {
-  fails(_excep_arr, (_excep_t*)excep_nullptr);
+  EXFC_FAILS(_excep_arr, (_excep_t*)excep_nullptr);
 
   /* Ensure no gaps exists */
   int rearrange = _exfc_rearrangement();
@@ -194,11 +262,22 @@ exfc_getallexcep()
   return rtn;
 }
 
+const _excep_t *
+_exfc_getexcep(int idx)
+{
+  if (idx < 0 || idx >= _excep_arr_len)
+    {
+      return NULL;
+    }
+
+  return &_excep_arr[idx];
+}
+
 int
 exfc_getindex_byname(const char *name)
 {
-  fails(_excep_arr, ABNORMAL);
-  fails(name, FAILED);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
 
   // _exfc_buffersize_chk((char *)name);
 
@@ -206,17 +285,43 @@ exfc_getindex_byname(const char *name)
   (void)fprintf(stdout, "getindex_byname: %s\n", _excep_arr[0]._name);
   /* TEST OVER */
 
+  /* Measured once here, not once per element. Longer than EXCEP_BUFF_MAX,
+     it matches nothing registered. */
+  return _exfc_getindex_byname_n(name, strnlen(name, EXCEP_BUFF_MAX + 1));
+}
+
+int
+exfc_getindex_byname_n(const char *name, unsigned long len)
+{
+  EXFC_FAILS(name, FAILED);
+  EXFC_TRANS(_exfc_name_len_chk(name, len), FAILED);
+
+  return _exfc_getindex_byname_n(name, len);
+}
+
+/* exfc_getindex_byname_n, once $len was checked. */
+static int
+_exfc_getindex_byname_n(const char *name, unsigned long len)
+{
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+
   for (register int i = 0; i < _excep_arr_len - 1; i ++)
     {
       /* TEST: seek $i, $_excep_arr[$i]._name */
       (void)fprintf(stdout, "%d\n%s", i, _excep_arr[i]._name);
       /* TEST OVER */
 
+      /* Emptied by a removal. */
+      if (_excep_arr[i]._name == NULL)
+        {
+          continue;
+        }
+
       const int match
-        = _exfc_quick_match_str(name, _excep_arr[i]._name, true);
+        = _exfc_quick_match_str_n(name, len, _excep_arr[i]._name, true);
 
       /* Once failed, fail. */
-      trans(match, FAILED);
+      EXFC_TRANS(match, FAILED);
 
       /* Once matched, return the index. */
       if (match == IDENTICAL)
@@ -230,7 +335,7 @@ exfc_getindex_byname(const char *name)
 int
 exfc_getindex_byid(int id)
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   if (id < 0)
     {
@@ -251,8 +356,8 @@ exfc_getindex_byid(int id)
 int
 exfc_getindex_byexcep(_excep_t e)
 {
-  fails(_excep_arr, ABNORMAL);
-  fails(&e, FAILED);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(&e, FAILED);
 
   if (exfc_cmp(&e, excep_nullptr) == IDENTICAL)
     {
@@ -276,14 +381,14 @@ exfc_getindex_byexcep(_excep_t e)
 int
 _exfc_iteration_last()
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   int rtn = -1;
   for (register int i = _excep_arr_len - 1; i >= 0; i --)
     {
       const int cmp = exfc_cmp(&_excep_arr[i], excep_nullptr);
 
-      trans(cmp, FAILED);
+      EXFC_TRANS(cmp, FAILED);
 
       /* Finding non-null elements, mark on. */
       if (cmp != IDENTICAL)
@@ -298,14 +403,14 @@ _exfc_iteration_last()
 int
 _exfc_iteration_first()
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   int rtn = -1;
   for (register int i = 0; i < _excep_arr_len; i ++)
     {
       const int cmp = exfc_cmp(&_excep_arr[i], excep_nullptr);
 
-      trans(cmp, FAILED);
+      EXFC_TRANS(cmp, FAILED);
 
       /* Finding non-null elements, mark on. */
       if (cmp != IDENTICAL)
@@ -320,7 +425,7 @@ _exfc_iteration_first()
 int
 _exfc_rearrangement()
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   _excep_t tmp[_excep_arr_len];
 
@@ -329,7 +434,7 @@ _exfc_rearrangement()
     {
       const int cmp = exfc_cmp(&_excep_arr[arr_index], excep_nullptr);
 
-      trans(cmp, FAILED);
+      EXFC_TRANS(cmp, FAILED);
 
       /* Continue once empty */
       if (cmp == IDENTICAL)
@@ -362,22 +467,25 @@ _exfc_rearrangement()
           _excep_arr[i] = excep_null;
         }
     }
+  /* Elements may have moved. */
+  _exfc_registry_bump();
+
   return tmp_index;
 }
 
 int
 _exfc_rearrangement_inplace()
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   /* Ensure target is not just a whole empty array, or a full filled array. */
   const int first = _exfc_iteration_first();
   const int last = _exfc_iteration_last();
 
-//  trans(first, FAILED);
-//  trans(first, ABNORMAL);
-//  trans(last, FAILED);
-//  trans(last, ABNORMAL);
+//  EXFC_TRANS(first, FAILED);
+//  EXFC_TRANS(first, ABNORMAL);
+//  EXFC_TRANS(last, FAILED);
+//  EXFC_TRANS(last, ABNORMAL);
 
   /* If _excep_arr is just empty on the whole, or have been full filled,
      return normally. */
@@ -401,7 +509,7 @@ _exfc_rearrangement_inplace()
           /* Move this element backwards for one. */
           const int swap = _exfc_swap(&_excep_arr[i], &_excep_arr[i - 1]);
 
-          trans(swap, FAILED);
+          EXFC_TRANS(swap, FAILED);
 
           /* Record current index */
           record_before_following = i;
@@ -440,6 +548,8 @@ _exfc_rearrangement_inplace()
           cnt += 1;
         }
     }
+  _exfc_registry_bump();
+
   return cnt;
 }
 
@@ -452,9 +562,9 @@ _exfc_quick_match_str(const char *a, const char *b,
   (void)fprintf(stdout, "quick_match_str: %s\n", _excep_arr[0]._name);
   /* TEST OVER */
 
-  fails(_excep_arr, ABNORMAL);
-  fails(a, FAILED);
-  fails(b, FAILED);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(a, FAILED);
+  EXFC_FAILS(b, FAILED);
 
   const unsigned long lenA = strlen(a);
   const unsigned long lenB = strlen(b);
@@ -469,7 +579,7 @@ _exfc_quick_match_str(const char *a, const char *b,
     {
       const int check = _exfc_capital_check(a[i], b[i], capital_restricted);
 
-      trans(check, ABNORMAL);
+      EXFC_TRANS(check, ABNORMAL);
 
       if (check == NORMAL)
         {
@@ -479,10 +589,41 @@ _exfc_quick_match_str(const char *a, const char *b,
   return IDENTICAL;
 }
 
+int
+_exfc_quick_match_str_n(const char *a, unsigned long lenA, const char *b,
+                        bool capital_restricted)
+{
+  EXFC_FAILS(_excep_arr, ABNORMAL);
+  EXFC_FAILS(a, FAILED);
+  EXFC_FAILS(b, FAILED);
+
+  /* $b is walked along with $a; it is never measured on its own. */
+  for (register unsigned long i = 0; i < lenA; i ++)
+    {
+      /* $b was shorter. */
+      if (b[i] == '\0')
+        {
+          return DIFFERENT;
+        }
+
+      const int check = _exfc_capital_check(a[i], b[i], capital_restricted);
+
+      EXFC_TRANS(check, ABNORMAL);
+
+      if (check == NORMAL)
+        {
+          return DIFFERENT;
+        }
+    }
+
+  /* $b was longer. */
+  return ((b[lenA] == '\0') ? IDENTICAL : DIFFERENT);
+}
+
 int
 _exfc_capital_check(char a, char b, bool capital_restricted)
 {
-  fails(_excep_arr, ABNORMAL);
+  EXFC_FAILS(_excep_arr, ABNORMAL);
 
   return ((capital_restricted) ? (a == b) : ((a - b) == ('a' - 'A'))
           ? IDENTICAL
@@ -492,12 +633,26 @@ _exfc_capital_check(char a, char b, bool capital_restricted)
 int
 _exfc_buffersize_chk(char *buff)
 {
-  fails(buff, FAILED);
+  unsigned long len;
+
+  return _exfc_buffersize_chk_n(buff, &len);
+}
+
+int
+_exfc_buffersize_chk_n(const char *buff, unsigned long *len)
+{
+  EXFC_FAILS(buff, FAILED);
+  EXFC_FAILS(len, FAILED);
+
+  /* Never look further than one byte past the limit. */
+  *len = strnlen(buff, EXCEP_BUFF_MAX + 1);
 
-  if (strlen((const char *)buff) > EXCEP_BUFF_MAX)
+  if (*len > EXCEP_BUFF_MAX)
     {
-      THROW(&(_excep_t){"BufferOverflowException", "", BufferOverflowException},
-            __FILE__, __LINE__, __FUNCTION__, EXCEP_FMT);
+      THROW(&exfc_emerg_overflow, __FILE__, __LINE__, __FUNCTION__, EXCEP_FMT);
+
+      /* A handler let it go on; still refuse the buffer. */
+      return FAILED;
     }
 
   return NORMAL;
@@ -0,0 +1,442 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "exfc_binlog.h"
+
+/* Largest header a record may need before its variable parts. */
+#define _EXFC_BINLOG_VARINT_MAX 10
+
+typedef struct _exfc_binlog_site_S
+{
+  const char *_file;
+  const char *_function;
+  long int _line;
+} _exfc_binlog_site;
+
+static int _exfc_binlog_fd = -1;
+static uint32_t _exfc_binlog_lock = 0;
+static uint64_t _exfc_binlog_last_us = 0;
+
+static unsigned char _exfc_binlog_buff[EXFC_BINLOG_BUFF_MAX];
+static size_t _exfc_binlog_len = 0;
+
+/* Site dictionary, open addressing. Slot index + 1 is the site ID. */
+static _exfc_binlog_site _exfc_binlog_sites[EXFC_BINLOG_DICT_MAX];
+static bool _exfc_binlog_site_used[EXFC_BINLOG_DICT_MAX];
+
+/* Exception IDs already described. */
+static int _exfc_binlog_excep[EXFC_BINLOG_DICT_MAX];
+static bool _exfc_binlog_excep_used[EXFC_BINLOG_DICT_MAX];
+
+static void
+_exfc_binlog_acquire()
+{
+  while (__atomic_exchange_n(&_exfc_binlog_lock, 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+      (void)sched_yield();
+    }
+}
+
+static void
+_exfc_binlog_release()
+{
+  __atomic_store_n(&_exfc_binlog_lock, 0u, __ATOMIC_RELEASE);
+}
+
+static uint64_t
+_exfc_binlog_now_us()
+{
+  struct timeval tv;
+
+  (void)gettimeofday(&tv, NULL);
+
+  return ((uint64_t)tv.tv_sec * 1000000u + (uint64_t)tv.tv_usec);
+}
+
+static uint64_t
+_exfc_binlog_zigzag(long int v)
+{
+  return (((uint64_t)v << 1) ^ (uint64_t)(v >> (sizeof(long int) * 8 - 1)));
+}
+
+static int
+_exfc_binlog_write_out()
+{
+  size_t done = 0;
+
+  while (done < _exfc_binlog_len)
+    {
+      const ssize_t w = write(_exfc_binlog_fd, &_exfc_binlog_buff[done],
+                              _exfc_binlog_len - done);
+      if (w < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          _exfc_binlog_len = 0;
+          return ABNORMAL;
+        }
+      done += (size_t)w;
+    }
+
+  _exfc_binlog_len = 0;
+  return NORMAL;
+}
+
+/* Make room for $len more bytes. */
+static int
+_exfc_binlog_reserve(size_t len)
+{
+  if (_exfc_binlog_len + len <= EXFC_BINLOG_BUFF_MAX)
+    {
+      return NORMAL;
+    }
+  return _exfc_binlog_write_out();
+}
+
+static void
+_exfc_binlog_put_byte(unsigned char c)
+{
+  _exfc_binlog_buff[_exfc_binlog_len ++] = c;
+}
+
+static void
+_exfc_binlog_put_varint(uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      _exfc_binlog_put_byte((unsigned char)(v | 0x80));
+      v >>= 7;
+    }
+  _exfc_binlog_put_byte((unsigned char)v);
+}
+
+static void
+_exfc_binlog_put_bytes(const void *p, size_t len)
+{
+  if (len > 0)
+    {
+      (void)memcpy(&_exfc_binlog_buff[_exfc_binlog_len], p, len);
+      _exfc_binlog_len += len;
+    }
+}
+
+/* Strings longer than EXCEP_BUFF_MAX are truncated. */
+static size_t
+_exfc_binlog_str_len(const char *s)
+{
+  if (s == NULL)
+    {
+      return 0;
+    }
+
+  const char *end = memchr(s, '\0', EXCEP_BUFF_MAX);
+
+  return ((end == NULL) ? EXCEP_BUFF_MAX : (size_t)(end - s));
+}
+
+static void
+_exfc_binlog_put_str(const char *s, size_t len)
+{
+  _exfc_binlog_put_varint(len);
+  _exfc_binlog_put_bytes(s, len);
+}
+
+/* Site ID of $file:$line, describing it once it was new. 0 when the
+   dictionary was full. */
+static uint64_t
+_exfc_binlog_site_id(const char *file, long int line, const char *function)
+{
+  /* __FILE__ & __FUNCTION__ are literals: identity by address suffices. */
+  unsigned int h = (unsigned int)(((uintptr_t)file >> 3)
+                                  ^ ((uintptr_t)function >> 3)) * 2654435761u
+                   ^ (unsigned int)line;
+
+  for (register int probe = 0; probe < EXFC_BINLOG_DICT_MAX; probe ++)
+    {
+      const unsigned int i = (h + (unsigned int)probe)
+                             & (EXFC_BINLOG_DICT_MAX - 1);
+      _exfc_binlog_site *s = &_exfc_binlog_sites[i];
+
+      if (_exfc_binlog_site_used[i])
+        {
+          if (s->_file == file && s->_line == line
+              && s->_function == function)
+            {
+              return i + 1;
+            }
+          continue;
+        }
+
+      const size_t file_len = _exfc_binlog_str_len(file);
+      const size_t func_len = _exfc_binlog_str_len(function);
+
+      if (_exfc_binlog_reserve(1 + _EXFC_BINLOG_VARINT_MAX * 4 + file_len
+                               + func_len) != NORMAL)
+        {
+          return 0;
+        }
+
+      _exfc_binlog_site_used[i] = true;
+      s->_file = file;
+      s->_line = line;
+      s->_function = function;
+
+      _exfc_binlog_put_byte(EXFC_BINLOG_TAG_SITE);
+      _exfc_binlog_put_varint(i + 1);
+      _exfc_binlog_put_varint(_exfc_binlog_zigzag(line));
+      _exfc_binlog_put_str(file, file_len);
+      _exfc_binlog_put_str(function, func_len);
+
+      return i + 1;
+    }
+  return 0;
+}
+
+/* Describe $except once it was not described yet. */
+static int
+_exfc_binlog_excep_describe(const _excep_t *except)
+{
+  const int id = except->_id;
+  const unsigned int h = (unsigned int)id * 2654435761u;
+
+  for (register int probe = 0; probe < EXFC_BINLOG_DICT_MAX; probe ++)
+    {
+      const unsigned int i = (h + (unsigned int)probe)
+                             & (EXFC_BINLOG_DICT_MAX - 1);
+
+      if (_exfc_binlog_excep_used[i])
+        {
+          if (_exfc_binlog_excep[i] == id)
+            {
+              return NORMAL;
+            }
+          continue;
+        }
+
+      const size_t name_len = _exfc_binlog_str_len(except->_name);
+      const size_t desc_len = _exfc_binlog_str_len(except->_description);
+
+      if (_exfc_binlog_reserve(1 + _EXFC_BINLOG_VARINT_MAX * 3 + name_len
+                               + desc_len) != NORMAL)
+        {
+          return ABNORMAL;
+        }
+
+      _exfc_binlog_excep_used[i] = true;
+      _exfc_binlog_excep[i] = id;
+
+      _exfc_binlog_put_byte(EXFC_BINLOG_TAG_EXCEP);
+      _exfc_binlog_put_varint(_exfc_binlog_zigzag(id));
+      _exfc_binlog_put_str(except->_name, name_len);
+      _exfc_binlog_put_str(except->_description, desc_len);
+
+      return NORMAL;
+    }
+
+  /* Dictionary full: describe it again on every event. */
+  return CONDITIONAL;
+}
+
+int
+exfc_binlog_open(const char *path)
+{
+  EXFC_FAILS(path, FAILED);
+
+  _exfc_binlog_acquire();
+
+  if (_exfc_binlog_fd >= 0)
+    {
+      _exfc_binlog_release();
+      return DUPLICATED;
+    }
+
+  const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      _exfc_binlog_release();
+      return ABNORMAL;
+    }
+
+  _exfc_binlog_fd = fd;
+  _exfc_binlog_len = 0;
+  (void)memset(_exfc_binlog_site_used, 0, sizeof(_exfc_binlog_site_used));
+  (void)memset(_exfc_binlog_excep_used, 0, sizeof(_exfc_binlog_excep_used));
+
+  _exfc_binlog_last_us = _exfc_binlog_now_us();
+  _exfc_binlog_put_bytes(EXFC_BINLOG_MAGIC, EXFC_BINLOG_MAGIC_LEN);
+  _exfc_binlog_put_varint(_exfc_binlog_last_us);
+
+  const int rtn = _exfc_binlog_write_out();
+
+  _exfc_binlog_release();
+
+  return rtn;
+}
+
+bool
+exfc_binlog_enabled()
+{
+  return (__atomic_load_n(&_exfc_binlog_fd, __ATOMIC_RELAXED) >= 0);
+}
+
+int
+exfc_binlog_record(const _excep_t *except, const char *file, long int line,
+                   const char *function, const void *arg, size_t len)
+{
+  EXFC_FAILS(except, FAILED);
+
+  if (arg == NULL)
+    {
+      len = 0;
+    }
+
+  if (len > EXFC_BINLOG_ARG_MAX)
+    {
+      len = EXFC_BINLOG_ARG_MAX;
+    }
+
+  _exfc_binlog_acquire();
+
+  if (_exfc_binlog_fd < 0)
+    {
+      _exfc_binlog_release();
+      return MISSING;
+    }
+
+  const int described = _exfc_binlog_excep_describe(except);
+  const uint64_t site = _exfc_binlog_site_id(file, line, function);
+
+  if (described == ABNORMAL
+      || _exfc_binlog_reserve(1 + _EXFC_BINLOG_VARINT_MAX * 4 + len)
+         != NORMAL)
+    {
+      _exfc_binlog_release();
+      return ABNORMAL;
+    }
+
+  /* Dictionary full: write the description right before the event, since
+     the decoder keeps the latest description of every ID. */
+  if (described == CONDITIONAL)
+    {
+      const size_t name_len = _exfc_binlog_str_len(except->_name);
+      const size_t desc_len = _exfc_binlog_str_len(except->_description);
+
+      if (_exfc_binlog_reserve(1 + _EXFC_BINLOG_VARINT_MAX * 3 + name_len
+                               + desc_len + 1 + _EXFC_BINLOG_VARINT_MAX * 4
+                               + len) != NORMAL)
+        {
+          _exfc_binlog_release();
+          return ABNORMAL;
+        }
+
+      _exfc_binlog_put_byte(EXFC_BINLOG_TAG_EXCEP);
+      _exfc_binlog_put_varint(_exfc_binlog_zigzag(except->_id));
+      _exfc_binlog_put_str(except->_name, name_len);
+      _exfc_binlog_put_str(except->_description, desc_len);
+    }
+
+  const uint64_t now = _exfc_binlog_now_us();
+  const uint64_t delta = (now > _exfc_binlog_last_us)
+                         ? now - _exfc_binlog_last_us : 0;
+  _exfc_binlog_last_us += delta;
+
+  _exfc_binlog_put_byte(EXFC_BINLOG_TAG_EVENT);
+  _exfc_binlog_put_varint(_exfc_binlog_zigzag(except->_id));
+  _exfc_binlog_put_varint(site);
+  _exfc_binlog_put_varint(delta);
+  _exfc_binlog_put_varint(len);
+  _exfc_binlog_put_bytes(arg, len);
+
+  _exfc_binlog_release();
+
+  return NORMAL;
+}
+
+int
+exfc_binlog_flush()
+{
+  _exfc_binlog_acquire();
+
+  if (_exfc_binlog_fd < 0)
+    {
+      _exfc_binlog_release();
+      return MISSING;
+    }
+
+  const int rtn = _exfc_binlog_write_out();
+
+  _exfc_binlog_release();
+
+  return rtn;
+}
+
+void
+_exfc_binlog_flush_signal()
+{
+  /* Never wait: the holder may be the very thread that faulted. */
+  if (__atomic_exchange_n(&_exfc_binlog_lock, 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+      return;
+    }
+
+  if (_exfc_binlog_fd >= 0)
+    {
+      (void)_exfc_binlog_write_out();
+    }
+
+  _exfc_binlog_release();
+}
+
+int
+exfc_binlog_close()
+{
+  _exfc_binlog_acquire();
+
+  if (_exfc_binlog_fd < 0)
+    {
+      _exfc_binlog_release();
+      return MISSING;
+    }
+
+  int rtn = _exfc_binlog_write_out();
+
+  if (close(_exfc_binlog_fd) != 0)
+    {
+      rtn = ABNORMAL;
+    }
+  __atomic_store_n(&_exfc_binlog_fd, -1, __ATOMIC_RELAXED);
+
+  _exfc_binlog_release();
+
+  return rtn;
+}
@@ -0,0 +1,265 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_block.c
+ * @brief ID blocks for modules.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "exfc_block.h"
+
+/* Reserved blocks, sorted by $_base. A block being released stays listed,
+   so its IDs are not handed out again before they are cleared. */
+static exfc_block _exfc_blocks[EXFC_BLOCK_MAX];
+static bool _exfc_block_releasing[EXFC_BLOCK_MAX];
+static int _exfc_block_len = 0;
+static uint32_t _exfc_block_lock = 0;
+
+static void
+_exfc_block_acquire()
+{
+  while (__atomic_exchange_n(&_exfc_block_lock, 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+      (void)sched_yield();
+    }
+}
+
+static void
+_exfc_block_release()
+{
+  __atomic_store_n(&_exfc_block_lock, 0u, __ATOMIC_RELEASE);
+}
+
+/* Position of MODULE in $_exfc_blocks, -1 once none. Called with the lock
+   held. */
+static int
+_exfc_block_seek(const char *module)
+{
+  for (register int i = 0; i < _exfc_block_len; i ++)
+    {
+      if (strcmp(_exfc_blocks[i]._module, module) == 0)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+int
+exfc_block_reserve(const char *module, int count, exfc_block *out)
+{
+  EXFC_FAILS(module, FAILED);
+  EXFC_FAILS(out, FAILED);
+  EXFC_CHECK(count > 0, FAILED);
+
+  _exfc_block_acquire();
+
+  const int held = _exfc_block_seek(module);
+  if (held >= 0)
+    {
+      const bool releasing = _exfc_block_releasing[held];
+      if (!releasing)
+        {
+          *out = _exfc_blocks[held];
+        }
+      _exfc_block_release();
+      return (releasing ? CONDITIONAL : DUPLICATED);
+    }
+
+  if (_exfc_block_len == EXFC_BLOCK_MAX)
+    {
+      _exfc_block_release();
+      return CONDITIONAL;
+    }
+
+  /* First fit: the lowest gap between blocks large enough for $count. */
+  int pos = 0;
+  int base = EXFC_BLOCK_ID_BASE;
+  for (; pos < _exfc_block_len; pos ++)
+    {
+      if (_exfc_blocks[pos]._base - base >= count)
+        {
+          break;
+        }
+      base = _exfc_blocks[pos]._base + _exfc_blocks[pos]._count;
+    }
+
+  if (EXFC_BLOCK_ID_END - base < count)
+    {
+      _exfc_block_release();
+      return CONDITIONAL;
+    }
+
+  (void)memmove(&_exfc_blocks[pos + 1], &_exfc_blocks[pos],
+                sizeof(exfc_block) * (_exfc_block_len - pos));
+  (void)memmove(&_exfc_block_releasing[pos + 1], &_exfc_block_releasing[pos],
+                sizeof(bool) * (_exfc_block_len - pos));
+  _exfc_blocks[pos] = (exfc_block){module, base, count};
+  _exfc_block_releasing[pos] = false;
+  _exfc_block_len ++;
+
+  *out = _exfc_blocks[pos];
+
+  _exfc_block_release();
+
+  return NORMAL;
+}
+
+int
+exfc_block_release(const exfc_block *block)
+{
+  EXFC_FAILS(block, FAILED);
+  EXFC_FAILS(block->_module, FAILED);
+
+  _exfc_block_acquire();
+
+  const int pos = _exfc_block_seek(block->_module);
+  if (pos < 0 || _exfc_block_releasing[pos]
+      || _exfc_blocks[pos]._base != block->_base
+      || _exfc_blocks[pos]._count != block->_count)
+    {
+      _exfc_block_release();
+      return MISSING;
+    }
+
+  /* Keep the IDs taken while clearing out what this module left. */
+  _exfc_block_releasing[pos] = true;
+
+  _exfc_block_release();
+
+  int removed = 0;
+  for (register int id = block->_base; id < block->_base + block->_count;
+       id ++)
+    {
+      if (exfc_removeexcep_byid(id) >= 0)
+        {
+          removed ++;
+        }
+      (void)exfc_handler_set(id, NULL, NULL);
+    }
+
+  /* Only now are the IDs free for others. Blocks may have moved
+     meanwhile; seek again. */
+  _exfc_block_acquire();
+
+  const int at = _exfc_block_seek(block->_module);
+  (void)memmove(&_exfc_blocks[at], &_exfc_blocks[at + 1],
+                sizeof(exfc_block) * (_exfc_block_len - at - 1));
+  (void)memmove(&_exfc_block_releasing[at], &_exfc_block_releasing[at + 1],
+                sizeof(bool) * (_exfc_block_len - at - 1));
+  _exfc_block_len --;
+
+  _exfc_block_release();
+
+  return removed;
+}
+
+int
+exfc_block_find(const char *module, exfc_block *out)
+{
+  EXFC_FAILS(module, FAILED);
+  EXFC_FAILS(out, FAILED);
+
+  _exfc_block_acquire();
+
+  const int pos = _exfc_block_seek(module);
+  const bool found = (pos >= 0 && !_exfc_block_releasing[pos]);
+  if (found)
+    {
+      *out = _exfc_blocks[pos];
+    }
+
+  _exfc_block_release();
+
+  return (found ? NORMAL : MISSING);
+}
+
+int
+exfc_block_owner(int id, exfc_block *out)
+{
+  EXFC_FAILS(out, FAILED);
+
+  int rtn = MISSING;
+
+  _exfc_block_acquire();
+
+  /* The last block starting at or below $id. */
+  int lo = 0;
+  int hi = _exfc_block_len;
+  while (lo < hi)
+    {
+      const int mid = lo + (hi - lo) / 2;
+      if (_exfc_blocks[mid]._base <= id)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  if (lo > 0 && !_exfc_block_releasing[lo - 1]
+      && id < _exfc_blocks[lo - 1]._base + _exfc_blocks[lo - 1]._count)
+    {
+      *out = _exfc_blocks[lo - 1];
+      rtn = NORMAL;
+    }
+
+  _exfc_block_release();
+
+  return rtn;
+}
+
+int
+exfc_block_addexcep(const exfc_block *block, const char *name,
+                    const char *description, int rel)
+{
+  EXFC_FAILS(block, FAILED);
+  EXFC_FAILS(block->_module, FAILED);
+
+  const int id = exfc_block_id(block, rel);
+  if (id < 0)
+    {
+      return CONDITIONAL;
+    }
+
+  /* $block may be a stale copy of one released since. */
+  _exfc_block_acquire();
+
+  const int pos = _exfc_block_seek(block->_module);
+  const bool reserved = (pos >= 0 && !_exfc_block_releasing[pos]
+                         && _exfc_blocks[pos]._base == block->_base
+                         && _exfc_blocks[pos]._count == block->_count);
+
+  _exfc_block_release();
+
+  if (!reserved)
+    {
+      return MISSING;
+    }
+
+  return exfc_addexcep(name, description, id);
+}
@@ -0,0 +1,34 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include "exfc_catch.h"
+
+__thread exfc_catch *_exfc_catch_top = NULL;
+
+void
+_exfc_catch_raise(exfc_catch *ctx)
+{
+  _exfc_catch_top = ctx->_prev;
+
+  siglongjmp(ctx->_env, 1);
+}
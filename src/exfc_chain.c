@@ -0,0 +1,137 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include "exfc_chain.h"
+
+/* Nodes are handed out from $_pool by bumping $_pool_used first, and from
+   $_free once put back; the pool is never walked. */
+static __thread exfc_cause _exfc_chain_pool[EXFC_CHAIN_MAX];
+static __thread unsigned int _exfc_chain_pool_used = 0;
+static __thread exfc_cause *_exfc_chain_free = NULL;
+
+/* Newest & oldest node of the chain; $_tail lets the whole chain go back
+   into $_free at once. */
+static __thread exfc_cause *_exfc_chain_first = NULL;
+static __thread exfc_cause *_exfc_chain_tail = NULL;
+static __thread unsigned int _exfc_chain_lost = 0;
+
+static __thread bool _exfc_chain_keep = false;
+
+exfc_cause *
+exfc_chain_head()
+{
+  return _exfc_chain_first;
+}
+
+unsigned int
+exfc_chain_dropped()
+{
+  return _exfc_chain_lost;
+}
+
+void
+exfc_chain_clear()
+{
+  if (_exfc_chain_first != NULL)
+    {
+      _exfc_chain_tail->_next = _exfc_chain_free;
+      _exfc_chain_free = _exfc_chain_first;
+    }
+
+  _exfc_chain_first = NULL;
+  _exfc_chain_tail = NULL;
+  _exfc_chain_lost = 0;
+}
+
+int
+_exfc_chain_push_site(const _excep_t *except, const char *file,
+                      long int line, const char *function)
+{
+  EXFC_FAILS(except, FAILED);
+
+  exfc_cause *node = _exfc_chain_free;
+  if (node != NULL)
+    {
+      _exfc_chain_free = node->_next;
+    }
+  else if (_exfc_chain_pool_used < EXFC_CHAIN_MAX)
+    {
+      node = &_exfc_chain_pool[_exfc_chain_pool_used ++];
+    }
+  else
+    {
+      _exfc_chain_lost += 1;
+      return CONDITIONAL;
+    }
+
+  node->_except = *except;
+  node->_file = file;
+  node->_line = line;
+  node->_function = function;
+  node->_next = _exfc_chain_first;
+
+  if (_exfc_chain_first == NULL)
+    {
+      _exfc_chain_tail = node;
+    }
+  _exfc_chain_first = node;
+
+  return NORMAL;
+}
+
+int
+_exfc_chain_push(const exfc_catch *ctx)
+{
+  EXFC_FAILS(ctx, FAILED);
+
+  return _exfc_chain_push_site(&ctx->_except, ctx->_file, ctx->_line,
+                               ctx->_function);
+}
+
+void
+_exfc_chain_set_keep()
+{
+  _exfc_chain_keep = true;
+}
+
+bool
+_exfc_chain_take_keep()
+{
+  const bool keep = _exfc_chain_keep;
+
+  _exfc_chain_keep = false;
+
+  return keep;
+}
+
+int
+exfc_rethrow(_excep_t *except, const exfc_catch *ctx,
+             const char *__restrict__ file, long int line,
+             const char *__restrict__ function,
+             const char *__restrict__ fmt)
+{
+  (void)_exfc_chain_push(ctx);
+  _exfc_chain_set_keep();
+
+  return _exfc_throw(except, file, line, function, fmt);
+}
@@ -0,0 +1,48 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <stdio.h>
+
+#include "exfc_check.h"
+
+static __thread exfc_check_site _exfc_check_latest = {0};
+
+void
+_exfc_check_fail(const char *expr, const char *file, long int line,
+                 const char *function, int rtn)
+{
+  _exfc_check_latest._expr = expr;
+  _exfc_check_latest._file = file;
+  _exfc_check_latest._line = line;
+  _exfc_check_latest._function = function;
+  _exfc_check_latest._rtn = rtn;
+
+#ifdef EXFC_CHECK_VERBOSE
+  (void)fprintf(stderr, "Check \"%s\" failed:\n\tat %s:%ld, func %s\n"
+                "\treturned %d\n", expr, file, line, function, rtn);
+#endif /* EXFC_CHECK_VERBOSE */
+}
+
+exfc_check_site
+exfc_check_last()
+{
+  return _exfc_check_latest;
+}
@@ -0,0 +1,201 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_emerg.c
+ * @brief Emergency path for OutOfMemoryException & BufferOverflowException.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "exfc_chain.h"
+#include "exfc_emerg.h"
+
+_excep_t exfc_emerg_oom = {
+  "OutOfMemoryException", "Ran out of memory.", OutOfMemoryException
+};
+
+_excep_t exfc_emerg_overflow = {
+  "BufferOverflowException", "Buffer was longer than EXCEP_BUFF_MAX.",
+  BufferOverflowException
+};
+
+static void *_exfc_emerg_reserve = NULL;
+
+/* One report at a time goes through the buffer. */
+static char _exfc_emerg_buff[EXFC_EMERG_BUFF_MAX];
+static uint32_t _exfc_emerg_lock = 0;
+
+static void
+_exfc_emerg_puts(int *pos, const char *s)
+{
+  if (s == NULL)
+    {
+      s = "(null)";
+    }
+
+  while (*s != '\0' && *pos < EXFC_EMERG_BUFF_MAX - 1)
+    {
+      _exfc_emerg_buff[(*pos) ++] = *s ++;
+    }
+}
+
+static void
+_exfc_emerg_putl(int *pos, long int v)
+{
+  char digits[sizeof(long int) * 3 + 1];
+  int n = 0;
+  unsigned long int u = (v < 0) ? -(unsigned long int)v : (unsigned long)v;
+
+  do
+    {
+      digits[n ++] = (char)('0' + u % 10);
+      u /= 10;
+    }
+  while (u != 0);
+
+  if (v < 0)
+    {
+      digits[n ++] = '-';
+    }
+
+  while (n > 0 && *pos < EXFC_EMERG_BUFF_MAX - 1)
+    {
+      _exfc_emerg_buff[(*pos) ++] = digits[-- n];
+    }
+}
+
+/* One EXCEPT_FMT-like block, led by LEAD. */
+static void
+_exfc_emerg_put(int *pos, const char *lead, const _excep_t *except,
+                const char *file, long int line, const char *function)
+{
+  _exfc_emerg_puts(pos, lead);
+  _exfc_emerg_puts(pos, except->_name);
+  _exfc_emerg_puts(pos, ":\n\tat ");
+  _exfc_emerg_puts(pos, file);
+  _exfc_emerg_puts(pos, ":");
+  _exfc_emerg_putl(pos, line);
+  _exfc_emerg_puts(pos, ", func ");
+  _exfc_emerg_puts(pos, function);
+  _exfc_emerg_puts(pos, "\n\"");
+  _exfc_emerg_puts(pos, except->_description);
+  _exfc_emerg_puts(pos, "\"\n");
+}
+
+int
+exfc_emerg_init(size_t size)
+{
+  if (__atomic_load_n(&_exfc_emerg_reserve, __ATOMIC_ACQUIRE) != NULL)
+    {
+      return DUPLICATED;
+    }
+
+  if (size == 0)
+    {
+      return NORMAL;
+    }
+
+  void *p = malloc(size);
+  if (p == NULL)
+    {
+      return ABNORMAL;
+    }
+  /* Touch every page, so the reserve is really backed. */
+  (void)memset(p, 0, size);
+
+  void *expected = NULL;
+  if (!__atomic_compare_exchange_n(&_exfc_emerg_reserve, &expected, p, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+      free(p);
+      return DUPLICATED;
+    }
+
+  return NORMAL;
+}
+
+bool
+exfc_emerg_reserved()
+{
+  return (__atomic_load_n(&_exfc_emerg_reserve, __ATOMIC_ACQUIRE) != NULL);
+}
+
+void
+_exfc_emerg_enter(const _excep_t *except)
+{
+  if (except->_id != OutOfMemoryException)
+    {
+      return;
+    }
+
+  /* Only one thread gets to free it. */
+  void *p = __atomic_exchange_n(&_exfc_emerg_reserve, NULL, __ATOMIC_ACQ_REL);
+  free(p);
+}
+
+void
+_exfc_emerg_report(const _excep_t *except, const char *file, long int line,
+                   const char *function)
+{
+  while (__atomic_exchange_n(&_exfc_emerg_lock, 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+      (void)sched_yield();
+    }
+
+  int pos = 0;
+  if (file == NULL && line == -1 && function == NULL)
+    {
+      _exfc_emerg_puts(&pos, "Threw the ");
+      _exfc_emerg_puts(&pos, except->_name);
+      _exfc_emerg_puts(&pos, "\n");
+    }
+  else
+    {
+      _exfc_emerg_put(&pos, "Threw the ", except, file, line, function);
+    }
+
+  for (exfc_cause *c = exfc_chain_head(); c != NULL; c = c->_next)
+    {
+      /* Flush whenever the next block may not fit. */
+      if (pos > EXFC_EMERG_BUFF_MAX / 2)
+        {
+          (void)write(STDERR_FILENO, _exfc_emerg_buff, (size_t)pos);
+          pos = 0;
+        }
+      _exfc_emerg_put(&pos, "Caused by the ", &c->_except, c->_file,
+                      c->_line, c->_function);
+    }
+
+  if (exfc_chain_dropped() > 0)
+    {
+      _exfc_emerg_puts(&pos, "\t... ");
+      _exfc_emerg_putl(&pos, (long int)exfc_chain_dropped());
+      _exfc_emerg_puts(&pos, " more causes dropped\n");
+    }
+
+  (void)write(STDERR_FILENO, _exfc_emerg_buff, (size_t)pos);
+
+  __atomic_store_n(&_exfc_emerg_lock, 0u, __ATOMIC_RELEASE);
+}
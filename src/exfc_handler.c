@@ -0,0 +1,86 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <stdlib.h>
+
+#include "exfc_handler.h"
+
+const exfc_handler *_exfc_handlers[EXFC_HANDLER_ID_MAX] = {NULL};
+
+int
+exfc_handler_set(int id, exfc_handler_fn fn, void *data)
+{
+  if (id < 0 || id >= EXFC_HANDLER_ID_MAX)
+    {
+      return FAILED;
+    }
+
+  exfc_handler *h = NULL;
+  if (fn != NULL)
+    {
+      h = malloc(sizeof(exfc_handler));
+      EXFC_FAILS(h, ABNORMAL);
+
+      h->_fn = fn;
+      h->_data = data;
+    }
+
+  /* Complete before visible: pairs with the acquire in
+     _exfc_handler_dispatch. */
+  __atomic_store_n(&_exfc_handlers[id], h, __ATOMIC_RELEASE);
+
+  return NORMAL;
+}
+
+int
+exfc_handler_set_subtree(int root, const _excep_t *table, const int *parent,
+                         int len, exfc_handler_fn fn, void *data)
+{
+  EXFC_FAILS(table, FAILED);
+  EXFC_FAILS(parent, FAILED);
+
+  int cnt = 0;
+  for (register int i = 0; i < len; i ++)
+    {
+      /* Walk up at most $len steps, a malformed table cannot loop. */
+      int p = i;
+      for (register int step = 0; p >= 0 && p < len && step <= len;
+           step ++)
+        {
+          if (table[p]._id == root)
+            {
+              break;
+            }
+          p = parent[p];
+        }
+
+      if (p < 0 || p >= len || table[p]._id != root)
+        {
+          continue;
+        }
+
+      if (exfc_handler_set(table[i]._id, fn, data) == NORMAL)
+        {
+          cnt += 1;
+        }
+    }
+  return cnt;
+}
@@ -0,0 +1,389 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exfc_image.h"
+
+/* Keep every section 8-byte aligned. */
+#define _EXFC_IMAGE_ALIGN(n) (((n) + 7u) & ~7u)
+
+static int
+_exfc_image_live(const _excep_t *e)
+{
+  return (e->_name != NULL && e->_name[0] != '\0');
+}
+
+static int
+_exfc_image_write_all(int fd, const void *buff, size_t len)
+{
+  const char *p = (const char *)buff;
+
+  while (len > 0)
+    {
+      const ssize_t w = write(fd, p, len);
+
+      if (w < 0)
+        {
+          return ABNORMAL;
+        }
+
+      p += w;
+      len -= (size_t)w;
+    }
+  return NORMAL;
+}
+
+/* Whether every entry, ID index & bucket of the image at BASE stays inside
+   of it. The section layout was checked already. */
+static bool
+_exfc_image_valid(const char *base, const exfc_image_hdr *hdr)
+{
+  const exfc_image_ent *ent = (const exfc_image_ent *)&base[hdr->_ent_off];
+  const uint32_t *byid = (const uint32_t *)&base[hdr->_byid_off];
+  const uint32_t *bucket = (const uint32_t *)&base[hdr->_bucket_off];
+  const char *str = &base[hdr->_str_off];
+
+  for (uint32_t i = 0; i < hdr->_count; i ++)
+    {
+      /* Names end exactly at $_name_len; the string table ends in '\0',
+         so every description in it ends too. */
+      if (ent[i]._name_off >= hdr->_str_len
+          || ent[i]._name_len >= hdr->_str_len - ent[i]._name_off
+          || str[ent[i]._name_off + ent[i]._name_len] != '\0'
+          || ent[i]._desc_off >= hdr->_str_len)
+        {
+          return false;
+        }
+
+      if (byid[i] >= hdr->_count
+          || (i > 0 && ent[byid[i - 1]]._id > ent[byid[i]]._id))
+        {
+          return false;
+        }
+    }
+
+  /* As many used buckets as entries, so probing always meets an empty
+     one ($_nbucket > $_count). */
+  uint32_t used = 0;
+  for (uint32_t b = 0; b < hdr->_nbucket; b ++)
+    {
+      if (bucket[b] > hdr->_count)
+        {
+          return false;
+        }
+      used += (bucket[b] != 0);
+    }
+
+  return (used == hdr->_count);
+}
+
+int
+exfc_image_save(const char *path)
+{
+  EXFC_FAILS(path, FAILED);
+
+  /* Count live exceptions and the size of their strings. */
+  uint32_t count = 0;
+  size_t str_len = 0;
+  const _excep_t *e;
+  for (register int i = 0; (e = _exfc_getexcep(i)) != NULL; i ++)
+    {
+      if (!_exfc_image_live(e))
+        {
+          continue;
+        }
+
+      count += 1;
+      str_len += strlen(e->_name) + 1;
+      str_len += strlen((e->_description == NULL)
+                        ? "" : e->_description) + 1;
+    }
+
+  /* Keep the load factor of the name table at most 1/2. */
+  uint32_t nbucket = 1;
+  while (nbucket < count * 2)
+    {
+      nbucket <<= 1;
+    }
+
+  exfc_image_hdr hdr = {0};
+  hdr._magic = EXFC_IMAGE_MAGIC;
+  hdr._version = EXFC_IMAGE_VERSION;
+  hdr._count = count;
+  hdr._nbucket = nbucket;
+  hdr._ent_off = _EXFC_IMAGE_ALIGN(sizeof(exfc_image_hdr));
+  hdr._byid_off = _EXFC_IMAGE_ALIGN(hdr._ent_off
+                                    + count * sizeof(exfc_image_ent));
+  hdr._bucket_off = _EXFC_IMAGE_ALIGN(hdr._byid_off
+                                      + count * sizeof(uint32_t));
+  hdr._str_off = _EXFC_IMAGE_ALIGN(hdr._bucket_off
+                                   + nbucket * sizeof(uint32_t));
+  hdr._str_len = (uint32_t)str_len;
+  hdr._size = hdr._str_off + hdr._str_len;
+
+  char *image = calloc(1, hdr._size);
+  EXFC_FAILS(image, ABNORMAL);
+
+  (void)memcpy(image, &hdr, sizeof(exfc_image_hdr));
+
+  exfc_image_ent *ent = (exfc_image_ent *)&image[hdr._ent_off];
+  uint32_t *byid = (uint32_t *)&image[hdr._byid_off];
+  uint32_t *bucket = (uint32_t *)&image[hdr._bucket_off];
+  char *str = &image[hdr._str_off];
+
+  /* Entries and string table */
+  uint32_t n = 0;
+  uint32_t str_pos = 0;
+  for (register int i = 0; (e = _exfc_getexcep(i)) != NULL; i ++)
+    {
+      if (!_exfc_image_live(e))
+        {
+          continue;
+        }
+
+      const char *name = e->_name;
+      const char *desc = (e->_description == NULL) ? "" : e->_description;
+      const size_t name_len = strlen(name);
+      const size_t desc_len = strlen(desc);
+
+      ent[n]._name_off = str_pos;
+      ent[n]._name_len = (uint32_t)name_len;
+      ent[n]._hash = _exfc_hash_str(name, name_len);
+      ent[n]._id = e->_id;
+      (void)memcpy(&str[str_pos], name, name_len + 1);
+      str_pos += (uint32_t)name_len + 1;
+
+      ent[n]._desc_off = str_pos;
+      (void)memcpy(&str[str_pos], desc, desc_len + 1);
+      str_pos += (uint32_t)desc_len + 1;
+
+      /* Insertion sort on ID; registries are built once, offline. */
+      uint32_t j = n;
+      while (j > 0 && ent[byid[j - 1]]._id > ent[n]._id)
+        {
+          byid[j] = byid[j - 1];
+          j -= 1;
+        }
+      byid[j] = n;
+
+      /* Name table, linear probing */
+      uint32_t b = ent[n]._hash & (nbucket - 1);
+      while (bucket[b] != 0)
+        {
+          b = (b + 1) & (nbucket - 1);
+        }
+      bucket[b] = n + 1;
+
+      n += 1;
+    }
+
+  /* Write aside under a unique name next to PATH, then rename into
+     place. */
+  const size_t tmp_len = strlen(path) + sizeof(".XXXXXX");
+  char tmp[tmp_len];
+  (void)snprintf(tmp, tmp_len, "%s.XXXXXX", path);
+
+  int rtn = ABNORMAL;
+  const int fd = mkstemp(tmp);
+  if (fd >= 0)
+    {
+      rtn = _exfc_image_write_all(fd, image, hdr._size);
+
+      /* mkstemp creates with 0600. */
+      if (rtn == NORMAL && fchmod(fd, 0644) != 0)
+        {
+          rtn = ABNORMAL;
+        }
+
+      if (close(fd) != 0)
+        {
+          rtn = ABNORMAL;
+        }
+
+      if (rtn == NORMAL && rename(tmp, path) != 0)
+        {
+          rtn = ABNORMAL;
+        }
+
+      if (rtn != NORMAL)
+        {
+          (void)unlink(tmp);
+        }
+    }
+
+  free(image);
+
+  return rtn;
+}
+
+int
+exfc_image_load(const char *path, exfc_image *img)
+{
+  EXFC_FAILS(path, FAILED);
+  EXFC_FAILS(img, FAILED);
+
+  (void)memset(img, 0, sizeof(exfc_image));
+
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    {
+      return ABNORMAL;
+    }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+    {
+      (void)close(fd);
+      return ABNORMAL;
+    }
+
+  if ((size_t)st.st_size < sizeof(exfc_image_hdr))
+    {
+      (void)close(fd);
+      return CONDITIONAL;
+    }
+
+  /* Shared mapping: every process mapping the same image shares its pages
+     through the page cache. */
+  void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  (void)close(fd);
+
+  if (base == MAP_FAILED)
+    {
+      return ABNORMAL;
+    }
+
+  const exfc_image_hdr *hdr = (const exfc_image_hdr *)base;
+  const uint64_t size = (uint64_t)st.st_size;
+
+  /* Validate the section layout before trusting any offset, then every
+     entry and bucket: a truncated or corrupted file is rejected here, and
+     never read out of bounds later. */
+  if (hdr->_magic != EXFC_IMAGE_MAGIC
+      || hdr->_version != EXFC_IMAGE_VERSION
+      || hdr->_size != size
+      || hdr->_nbucket == 0
+      || (hdr->_nbucket & (hdr->_nbucket - 1)) != 0
+      || hdr->_nbucket <= hdr->_count
+      || hdr->_ent_off < sizeof(exfc_image_hdr)
+      || hdr->_ent_off + (uint64_t)hdr->_count * sizeof(exfc_image_ent)
+         > hdr->_byid_off
+      || hdr->_byid_off + (uint64_t)hdr->_count * sizeof(uint32_t)
+         > hdr->_bucket_off
+      || hdr->_bucket_off + (uint64_t)hdr->_nbucket * sizeof(uint32_t)
+         > hdr->_str_off
+      || (uint64_t)hdr->_str_off + hdr->_str_len != size
+      || ((hdr->_ent_off | hdr->_byid_off | hdr->_bucket_off) & 3u) != 0
+      || (hdr->_str_len > 0
+          && ((const char *)base)[size - 1] != '\0')
+      || !_exfc_image_valid((const char *)base, hdr))
+    {
+      (void)munmap(base, (size_t)st.st_size);
+      return CONDITIONAL;
+    }
+
+  img->_base = base;
+  img->_size = (size_t)st.st_size;
+  img->_hdr = hdr;
+  img->_ent = (const exfc_image_ent *)((const char *)base + hdr->_ent_off);
+  img->_byid = (const uint32_t *)((const char *)base + hdr->_byid_off);
+  img->_bucket = (const uint32_t *)((const char *)base + hdr->_bucket_off);
+  img->_str = (const char *)base + hdr->_str_off;
+
+  return NORMAL;
+}
+
+void
+exfc_image_unload(exfc_image *img)
+{
+  if (img == NULL || img->_base == NULL)
+    {
+      return;
+    }
+
+  (void)munmap((void *)img->_base, img->_size);
+  (void)memset(img, 0, sizeof(exfc_image));
+}
+
+int
+exfc_image_getindex_byname(const exfc_image *img, const char *name)
+{
+  EXFC_FAILS(img, FAILED);
+  EXFC_FAILS(img->_hdr, FAILED);
+  EXFC_FAILS(name, FAILED);
+
+  const uint32_t mask = img->_hdr->_nbucket - 1;
+  const size_t len = strlen(name);
+  const uint32_t hash = _exfc_hash_str(name, len);
+
+  for (uint32_t b = hash & mask; img->_bucket[b] != 0; b = (b + 1) & mask)
+    {
+      const uint32_t idx = img->_bucket[b] - 1;
+      const exfc_image_ent *ent = &img->_ent[idx];
+
+      if (ent->_hash == hash && ent->_name_len == len
+          && memcmp(&img->_str[ent->_name_off], name, len) == 0)
+        {
+          return (int)idx;
+        }
+    }
+  return MISSING;
+}
+
+int
+exfc_image_getindex_byid(const exfc_image *img, int id)
+{
+  EXFC_FAILS(img, FAILED);
+  EXFC_FAILS(img->_hdr, FAILED);
+
+  uint32_t lo = 0;
+  uint32_t hi = img->_hdr->_count;
+
+  while (lo < hi)
+    {
+      const uint32_t mid = lo + (hi - lo) / 2;
+      const int32_t cur = img->_ent[img->_byid[mid]]._id;
+
+      if (cur == id)
+        {
+          return (int)img->_byid[mid];
+        }
+
+      if (cur < id)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  return MISSING;
+}
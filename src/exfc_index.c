@@ -0,0 +1,199 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <string.h>
+
+#include "exfc_index.h"
+
+/* Both are dense & sorted; insertion & removal shift the tail. */
+static exfc_index_ent _exfc_index_byname[EXCEP_ARRAY_MAX];
+static exfc_index_ent _exfc_index_byid[EXCEP_ARRAY_MAX];
+static int _exfc_index_len = 0;
+
+/* Order on names: bytewise, a prefix going first. */
+static int
+_exfc_index_cmp_name(const char *a, unsigned int lena, const char *b,
+                     unsigned int lenb)
+{
+  const int cmp = memcmp(a, b, (lena < lenb) ? lena : lenb);
+
+  if (cmp != 0)
+    {
+      return cmp;
+    }
+  return ((lena > lenb) - (lena < lenb));
+}
+
+/* First position in $_byname not ordered before $name. */
+static int
+_exfc_index_lower_name(const char *name, unsigned int len)
+{
+  int lo = 0;
+  int hi = _exfc_index_len;
+
+  while (lo < hi)
+    {
+      const int mid = lo + (hi - lo) / 2;
+      const exfc_index_ent *e = &_exfc_index_byname[mid];
+
+      if (_exfc_index_cmp_name(e->_name, e->_len, name, len) < 0)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  return lo;
+}
+
+/* First position in $_byid whose ID is not less than $id. */
+static int
+_exfc_index_lower_id(int id)
+{
+  int lo = 0;
+  int hi = _exfc_index_len;
+
+  while (lo < hi)
+    {
+      const int mid = lo + (hi - lo) / 2;
+
+      if (_exfc_index_byid[mid]._id < id)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  return lo;
+}
+
+int
+_exfc_index_insert(const char *name, unsigned int len, int id)
+{
+  EXFC_FAILS(name, FAILED);
+
+  if (_exfc_index_len == EXCEP_ARRAY_MAX)
+    {
+      return CONDITIONAL;
+    }
+
+  const int at_id = _exfc_index_lower_id(id);
+  if (at_id < _exfc_index_len && _exfc_index_byid[at_id]._id == id)
+    {
+      return DUPLICATED;
+    }
+
+  const int at_name = _exfc_index_lower_name(name, len);
+  const exfc_index_ent ent = {name, len, id};
+
+  (void)memmove(&_exfc_index_byid[at_id + 1], &_exfc_index_byid[at_id],
+                sizeof(exfc_index_ent) * (size_t)(_exfc_index_len - at_id));
+  _exfc_index_byid[at_id] = ent;
+
+  (void)memmove(&_exfc_index_byname[at_name + 1],
+                &_exfc_index_byname[at_name],
+                sizeof(exfc_index_ent) * (size_t)(_exfc_index_len - at_name));
+  _exfc_index_byname[at_name] = ent;
+
+  _exfc_index_len += 1;
+
+  return NORMAL;
+}
+
+int
+_exfc_index_remove(int id)
+{
+  const int at_id = _exfc_index_lower_id(id);
+
+  if (at_id == _exfc_index_len || _exfc_index_byid[at_id]._id != id)
+    {
+      return MISSING;
+    }
+
+  const exfc_index_ent ent = _exfc_index_byid[at_id];
+
+  /* Names are unique, but step over equal ones anyway. */
+  int at_name = _exfc_index_lower_name(ent._name, ent._len);
+  while (at_name < _exfc_index_len
+         && _exfc_index_byname[at_name]._id != id)
+    {
+      at_name += 1;
+    }
+
+  _exfc_index_len -= 1;
+
+  (void)memmove(&_exfc_index_byid[at_id], &_exfc_index_byid[at_id + 1],
+                sizeof(exfc_index_ent) * (size_t)(_exfc_index_len - at_id));
+
+  if (at_name <= _exfc_index_len)
+    {
+      (void)memmove(&_exfc_index_byname[at_name],
+                    &_exfc_index_byname[at_name + 1],
+                    sizeof(exfc_index_ent)
+                    * (size_t)(_exfc_index_len - at_name));
+    }
+
+  return NORMAL;
+}
+
+int
+exfc_index_prefix(const char *prefix, exfc_index_ent *out, int max)
+{
+  EXFC_FAILS(prefix, FAILED);
+  EXFC_FAILS(out, FAILED);
+
+  const unsigned int len = (unsigned int)strlen(prefix);
+  int n = 0;
+
+  /* Every name beginning with $prefix sorts right after $prefix itself. */
+  for (int i = _exfc_index_lower_name(prefix, len);
+       i < _exfc_index_len && n < max; i ++)
+    {
+      const exfc_index_ent *e = &_exfc_index_byname[i];
+
+      if (e->_len < len || memcmp(e->_name, prefix, len) != 0)
+        {
+          break;
+        }
+      out[n ++] = *e;
+    }
+  return n;
+}
+
+int
+exfc_index_range(int lo, int hi, exfc_index_ent *out, int max)
+{
+  EXFC_FAILS(out, FAILED);
+
+  int n = 0;
+
+  for (int i = _exfc_index_lower_id(lo);
+       i < _exfc_index_len && n < max && _exfc_index_byid[i]._id <= hi;
+       i ++)
+    {
+      out[n ++] = _exfc_index_byid[i];
+    }
+  return n;
+}
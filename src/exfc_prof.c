@@ -0,0 +1,270 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_prof.c
+ * @brief Throw-site profiler.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <execinfo.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "exfc_prof.h"
+
+/* Frames of the profiler itself on top of every stack: _exfc_prof_sample
+   and _exfc_throw. THROW & _exfc_prof_tick are always inlined, and THROW
+   is never a tail call, but the function throwing may still be missing:
+   inlined into its caller, for one. The function THROW was given is thus
+   kept as well, and put as the innermost frame once it was missing. */
+#define _EXFC_PROF_SKIP 2
+
+/*
+   A slot is claimed by swapping its $_hash from 0 to the hash of the stack;
+   the claimer then fills the frames in and publishes them through $_ready.
+   Every other sample of the same stack only adds to $_count, so slots are
+   never locked. A stack being claimed while dumping is skipped.
+*/
+
+typedef struct _exfc_prof_slot_S
+{
+  uint64_t _hash;
+  uint32_t _ready;
+  uint32_t _depth;
+  const char *_name;
+  const char *_site;
+  unsigned long int _count;
+  void *_frame[EXFC_PROF_DEPTH_MAX];
+} _exfc_prof_slot;
+
+unsigned int _exfc_prof_rate = 0;
+
+static _exfc_prof_slot _exfc_prof_slots[EXFC_PROF_SLOT_MAX];
+static unsigned long int _exfc_prof_lost = 0;
+
+static __thread unsigned int _exfc_prof_countdown = 0;
+
+static uint64_t
+_exfc_prof_hash(void *const *frame, int depth, int id, const char *site)
+{
+  uint64_t h = 14695981039346656037u;
+
+  for (register int i = 0; i < depth; i ++)
+    {
+      h = (h ^ (uint64_t)(uintptr_t)frame[i]) * 1099511628211u;
+    }
+  h = (h ^ (uint64_t)(uint32_t)id) * 1099511628211u;
+  h = (h ^ (uint64_t)(uintptr_t)site) * 1099511628211u;
+
+  /* 0 marks an empty slot. */
+  return (h == 0 ? 1 : h);
+}
+
+int
+exfc_prof_start(unsigned int rate)
+{
+  if (rate == 0)
+    {
+      return FAILED;
+    }
+
+  /* The first backtrace loads libgcc; do it here rather than in a THROW. */
+  void *warm[1];
+  (void)backtrace(warm, 1);
+
+  __atomic_store_n(&_exfc_prof_rate, rate, __ATOMIC_RELEASE);
+
+  return NORMAL;
+}
+
+void
+exfc_prof_stop()
+{
+  __atomic_store_n(&_exfc_prof_rate, 0u, __ATOMIC_RELEASE);
+}
+
+int
+exfc_prof_reset()
+{
+  if (__atomic_load_n(&_exfc_prof_rate, __ATOMIC_ACQUIRE) != 0)
+    {
+      return ABNORMAL;
+    }
+
+  /* Samples taken just before stopping may still be claiming slots: hide
+     every slot from exfc_prof_dump first, then free it for claiming. The
+     frames are rewritten by the next claimer before it sets $_ready. */
+  for (register unsigned int i = 0; i < EXFC_PROF_SLOT_MAX; i ++)
+    {
+      _exfc_prof_slot *s = &_exfc_prof_slots[i];
+
+      __atomic_store_n(&s->_ready, 0u, __ATOMIC_RELEASE);
+      __atomic_store_n(&s->_count, 0ul, __ATOMIC_RELAXED);
+      __atomic_store_n(&s->_hash, 0u, __ATOMIC_RELEASE);
+    }
+  __atomic_store_n(&_exfc_prof_lost, 0ul, __ATOMIC_RELEASE);
+
+  return NORMAL;
+}
+
+unsigned long int
+exfc_prof_lost()
+{
+  return __atomic_load_n(&_exfc_prof_lost, __ATOMIC_RELAXED);
+}
+
+void
+_exfc_prof_sample(const _excep_t *except, const char *function)
+{
+  const unsigned int rate = __atomic_load_n(&_exfc_prof_rate,
+                                            __ATOMIC_RELAXED);
+  if (rate == 0 || except == NULL)
+    {
+      return;
+    }
+
+  /* Sample one out of every $rate throws of this thread. */
+  if (_exfc_prof_countdown > 1)
+    {
+      _exfc_prof_countdown --;
+      return;
+    }
+  _exfc_prof_countdown = rate;
+
+  void *frame[EXFC_PROF_DEPTH_MAX + _EXFC_PROF_SKIP];
+  int depth = backtrace(frame, EXFC_PROF_DEPTH_MAX + _EXFC_PROF_SKIP);
+  depth = (depth > _EXFC_PROF_SKIP ? depth - _EXFC_PROF_SKIP : 0);
+
+  void *const *stack = frame + _EXFC_PROF_SKIP;
+  const uint64_t hash = _exfc_prof_hash(stack, depth, except->_id,
+                                        function);
+
+  for (register uint64_t i = 0; i < EXFC_PROF_SLOT_MAX; i ++)
+    {
+      _exfc_prof_slot *s
+        = &_exfc_prof_slots[(hash + i) & (EXFC_PROF_SLOT_MAX - 1)];
+
+      uint64_t cur = __atomic_load_n(&s->_hash, __ATOMIC_ACQUIRE);
+      if (cur == 0)
+        {
+          if (__atomic_compare_exchange_n(&s->_hash, &cur, hash, false,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE))
+            {
+              (void)memcpy(s->_frame, stack, sizeof(void *) * depth);
+              s->_depth = (uint32_t)depth;
+              s->_name = except->_name;
+              s->_site = function;
+              __atomic_store_n(&s->_ready, 1u, __ATOMIC_RELEASE);
+              (void)__atomic_add_fetch(&s->_count, 1ul, __ATOMIC_RELAXED);
+              return;
+            }
+          /* Lost the race; $cur now holds the winner's hash. */
+        }
+
+      if (cur == hash)
+        {
+          (void)__atomic_add_fetch(&s->_count, 1ul, __ATOMIC_RELAXED);
+          return;
+        }
+    }
+
+  (void)__atomic_add_fetch(&_exfc_prof_lost, 1ul, __ATOMIC_RELAXED);
+}
+
+/* The function name in a backtrace_symbols line, which looks like
+   "bin/test(parse+0x1a) [0x55d0c1a2b3c4]"; NULL once it has none. */
+static const char *
+_exfc_prof_symname(const char *sym, size_t *len)
+{
+  const char *begin = (sym == NULL ? NULL : strchr(sym, '('));
+  if (begin == NULL)
+    {
+      return NULL;
+    }
+
+  begin ++;
+  *len = strcspn(begin, "+)");
+
+  return (*len > 0 ? begin : NULL);
+}
+
+/* Write the function name of a frame; its address once it has none. */
+static void
+_exfc_prof_putframe(FILE *stream, const char *sym, void *addr)
+{
+  size_t len = 0;
+  const char *name = _exfc_prof_symname(sym, &len);
+  if (name != NULL)
+    {
+      (void)fwrite(name, 1, len, stream);
+      return;
+    }
+
+  (void)fprintf(stream, "%p", addr);
+}
+
+int
+exfc_prof_dump(FILE *stream)
+{
+  EXFC_FAILS(stream, FAILED);
+
+  int lines = 0;
+  for (register int i = 0; i < EXFC_PROF_SLOT_MAX; i ++)
+    {
+      _exfc_prof_slot *s = &_exfc_prof_slots[i];
+      if (__atomic_load_n(&s->_ready, __ATOMIC_ACQUIRE) == 0)
+        {
+          continue;
+        }
+
+      const int depth = (int)s->_depth;
+      char **sym = backtrace_symbols(s->_frame, depth);
+
+      /* Outermost frame first. */
+      for (register int f = depth - 1; f >= 0; f --)
+        {
+          _exfc_prof_putframe(stream, (sym == NULL ? NULL : sym[f]),
+                              s->_frame[f]);
+          (void)fputc(';', stream);
+        }
+
+      /* The function throwing, once the stack did not end in it. */
+      size_t len = 0;
+      const char *leaf = _exfc_prof_symname((sym == NULL || depth == 0)
+                                            ? NULL : sym[0], &len);
+      if (s->_site != NULL
+          && (leaf == NULL || strncmp(leaf, s->_site, len) != 0
+              || s->_site[len] != '\0'))
+        {
+          (void)fprintf(stream, "%s;", s->_site);
+        }
+
+      (void)fprintf(stream, "%s %lu\n",
+                    (s->_name == NULL ? "?" : s->_name),
+                    __atomic_load_n(&s->_count, __ATOMIC_RELAXED));
+
+      free(sym);
+      lines ++;
+    }
+
+  return lines;
+}
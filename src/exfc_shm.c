@@ -0,0 +1,631 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exfc_shm.h"
+
+/* How many times attaching waits for another process to finish creating
+   the region, yielding in between. */
+#define _EXFC_SHM_WAIT_MAX 100000
+
+static exfc_shm_region *_exfc_shm = NULL;
+
+/* Bytes of $_str in use by one entry, for reusing the rest. */
+typedef struct _exfc_shm_range_S
+{
+  uint32_t _off;
+  uint32_t _end;
+} _exfc_shm_range;
+
+/* Only touched with the writer lock held. */
+static _exfc_shm_range _exfc_shm_ranges[2 * EXFC_SHM_ENTRY_MAX];
+
+static void _exfc_shm_repair(exfc_shm_region *r);
+
+/* Take the writer lock, repairing the region once its former holder
+   died. */
+static int
+_exfc_shm_lock(exfc_shm_region *r)
+{
+  const int rc = pthread_mutex_lock(&r->_lock);
+
+  if (rc == EOWNERDEAD)
+    {
+      _exfc_shm_repair(r);
+      if (pthread_mutex_consistent(&r->_lock) != 0)
+        {
+          (void)pthread_mutex_unlock(&r->_lock);
+          return ABNORMAL;
+        }
+      return NORMAL;
+    }
+
+  return ((rc == 0) ? NORMAL : ABNORMAL);
+}
+
+static void
+_exfc_shm_unlock(exfc_shm_region *r)
+{
+  (void)pthread_mutex_unlock(&r->_lock);
+}
+
+static void
+_exfc_shm_write_begin(exfc_shm_region *r)
+{
+  const uint32_t s = __atomic_load_n(&r->_seq, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&r->_seq, s + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void
+_exfc_shm_write_end(exfc_shm_region *r)
+{
+  const uint32_t s = __atomic_load_n(&r->_seq, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&r->_seq, s + 1, __ATOMIC_RELEASE);
+}
+
+static uint32_t
+_exfc_shm_read_begin(exfc_shm_region *r)
+{
+  uint32_t s;
+  uint32_t last = 0;
+  int spin = 0;
+
+  while ((s = __atomic_load_n(&r->_seq, __ATOMIC_ACQUIRE)) & 1u)
+    {
+      if (s != last)
+        {
+          last = s;
+          spin = 0;
+        }
+
+      /* Stuck in one write section: wait for its writer on $_lock, which
+         repairs the region should the writer have died. */
+      if (++ spin >= EXFC_SHM_READ_SPIN)
+        {
+          if (_exfc_shm_lock(r) == NORMAL)
+            {
+              _exfc_shm_unlock(r);
+            }
+          spin = 0;
+          continue;
+        }
+
+      (void)sched_yield();
+    }
+  return s;
+}
+
+static bool
+_exfc_shm_read_retry(const exfc_shm_region *r, uint32_t s)
+{
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+  return (__atomic_load_n(&r->_seq, __ATOMIC_RELAXED) != s);
+}
+
+/* Entries are read while a writer may be modifying them; every field is
+   loaded atomically and the copy is only trusted once $_seq confirms it. */
+static exfc_shm_ent
+_exfc_shm_load_ent(const exfc_shm_ent *e)
+{
+  exfc_shm_ent rtn;
+
+  rtn._used = __atomic_load_n(&e->_used, __ATOMIC_RELAXED);
+  rtn._name_off = __atomic_load_n(&e->_name_off, __ATOMIC_RELAXED);
+  rtn._name_len = __atomic_load_n(&e->_name_len, __ATOMIC_RELAXED);
+  rtn._desc_off = __atomic_load_n(&e->_desc_off, __ATOMIC_RELAXED);
+  rtn._desc_len = __atomic_load_n(&e->_desc_len, __ATOMIC_RELAXED);
+  rtn._id = __atomic_load_n(&e->_id, __ATOMIC_RELAXED);
+
+  return rtn;
+}
+
+static void
+_exfc_shm_store_ent(exfc_shm_ent *e, const exfc_shm_ent *src)
+{
+  __atomic_store_n(&e->_used, src->_used, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->_name_off, src->_name_off, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->_name_len, src->_name_len, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->_desc_off, src->_desc_off, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->_desc_len, src->_desc_len, __ATOMIC_RELAXED);
+  __atomic_store_n(&e->_id, src->_id, __ATOMIC_RELAXED);
+}
+
+/* Whether $e names a string range that was completely published. */
+static bool
+_exfc_shm_ent_sane(const exfc_shm_region *r, const exfc_shm_ent *e)
+{
+  const uint32_t used = __atomic_load_n(&r->_str_used, __ATOMIC_ACQUIRE);
+
+  return (used <= EXFC_SHM_STR_MAX
+          && e->_name_off < used && e->_name_len < used - e->_name_off
+          && e->_desc_off < used && e->_desc_len < used - e->_desc_off);
+}
+
+/* Called with the lock just taken over from a dead holder. Entries are
+   only written between _exfc_shm_write_begin & _exfc_shm_write_end; an odd
+   $_seq means the holder died in between, so drop whatever entry does not
+   hold together, and let readers go on. */
+static void
+_exfc_shm_repair(exfc_shm_region *r)
+{
+  if ((__atomic_load_n(&r->_seq, __ATOMIC_RELAXED) & 1u) == 0)
+    {
+      return;
+    }
+
+  for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+    {
+      const exfc_shm_ent e = _exfc_shm_load_ent(&r->_ent[i]);
+
+      if (e._used && (!_exfc_shm_ent_sane(r, &e)
+                      || r->_str[e._name_off + e._name_len] != '\0'
+                      || r->_str[e._desc_off + e._desc_len] != '\0'))
+        {
+          const exfc_shm_ent empty = {0};
+          _exfc_shm_store_ent(&r->_ent[i], &empty);
+        }
+    }
+
+  _exfc_shm_write_end(r);
+}
+
+static int
+_exfc_shm_range_cmp(const void *a, const void *b)
+{
+  const uint32_t x = ((const _exfc_shm_range *)a)->_off;
+  const uint32_t y = ((const _exfc_shm_range *)b)->_off;
+
+  return ((x > y) - (x < y));
+}
+
+/* Find NEED free bytes of $_str: past every string in use, or else between
+   them. Writer lock must be held. */
+static int
+_exfc_shm_alloc_str(exfc_shm_region *r, uint32_t need, uint32_t *off)
+{
+  const uint32_t used = r->_str_used;
+
+  if (need <= EXFC_SHM_STR_MAX - used)
+    {
+      *off = used;
+      __atomic_store_n(&r->_str_used, used + need, __ATOMIC_RELEASE);
+      return NORMAL;
+    }
+
+  /* Out of fresh bytes: look for room left by removed entries. */
+  int n = 0;
+  for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+    {
+      const exfc_shm_ent *e = &r->_ent[i];
+      if (!e->_used)
+        {
+          continue;
+        }
+      _exfc_shm_ranges[n ++] = (_exfc_shm_range){
+        e->_name_off, e->_name_off + e->_name_len + 1
+      };
+      _exfc_shm_ranges[n ++] = (_exfc_shm_range){
+        e->_desc_off, e->_desc_off + e->_desc_len + 1
+      };
+    }
+  qsort(_exfc_shm_ranges, (size_t)n, sizeof(_exfc_shm_range),
+        _exfc_shm_range_cmp);
+
+  uint32_t at = 0;
+  for (register int i = 0; i < n; i ++)
+    {
+      if (_exfc_shm_ranges[i]._off >= at
+          && _exfc_shm_ranges[i]._off - at >= need)
+        {
+          *off = at;
+          return NORMAL;
+        }
+      if (_exfc_shm_ranges[i]._end > at)
+        {
+          at = _exfc_shm_ranges[i]._end;
+        }
+    }
+
+  /* Past the last string in use; this also takes back the tail. */
+  if (need <= EXFC_SHM_STR_MAX - at)
+    {
+      *off = at;
+      __atomic_store_n(&r->_str_used, at + need, __ATOMIC_RELEASE);
+      return NORMAL;
+    }
+
+  return CONDITIONAL;
+}
+
+static bool
+_exfc_shm_wait(const uint32_t *word, uint32_t expected)
+{
+  for (register int i = 0; i < _EXFC_SHM_WAIT_MAX; i ++)
+    {
+      if (__atomic_load_n(word, __ATOMIC_ACQUIRE) == expected)
+        {
+          return true;
+        }
+      (void)sched_yield();
+    }
+  return false;
+}
+
+int
+exfc_shm_attach(const char *name)
+{
+  EXFC_FAILS(name, FAILED);
+
+  if (_exfc_shm != NULL)
+    {
+      return DUPLICATED;
+    }
+
+  bool created = true;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0 && errno == EEXIST)
+    {
+      created = false;
+      fd = shm_open(name, O_RDWR, 0600);
+    }
+
+  if (fd < 0)
+    {
+      return ABNORMAL;
+    }
+
+  if (created)
+    {
+      /* ftruncate zero-fills: every entry starts out unused. */
+      if (ftruncate(fd, sizeof(exfc_shm_region)) != 0)
+        {
+          (void)close(fd);
+          (void)shm_unlink(name);
+          return ABNORMAL;
+        }
+    }
+  else
+    {
+      /* The creator may not have sized the object yet. */
+      struct stat st;
+      register int i = 0;
+      for (; i < _EXFC_SHM_WAIT_MAX; i ++)
+        {
+          if (fstat(fd, &st) != 0)
+            {
+              (void)close(fd);
+              return ABNORMAL;
+            }
+
+          if (st.st_size != 0)
+            {
+              break;
+            }
+          (void)sched_yield();
+        }
+
+      if ((size_t)st.st_size != sizeof(exfc_shm_region))
+        {
+          (void)close(fd);
+          return CONDITIONAL;
+        }
+    }
+
+  void *base = mmap(NULL, sizeof(exfc_shm_region), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  (void)close(fd);
+
+  if (base == MAP_FAILED)
+    {
+      return ABNORMAL;
+    }
+
+  exfc_shm_region *r = (exfc_shm_region *)base;
+
+  if (created)
+    {
+      pthread_mutexattr_t attr;
+      bool ready = (pthread_mutexattr_init(&attr) == 0);
+      if (ready)
+        {
+          ready = (pthread_mutexattr_setpshared(&attr,
+                                                PTHREAD_PROCESS_SHARED) == 0
+                   && pthread_mutexattr_setrobust(&attr,
+                                                  PTHREAD_MUTEX_ROBUST) == 0
+                   && pthread_mutex_init(&r->_lock, &attr) == 0);
+          (void)pthread_mutexattr_destroy(&attr);
+        }
+
+      if (!ready)
+        {
+          (void)munmap(base, sizeof(exfc_shm_region));
+          (void)shm_unlink(name);
+          return ABNORMAL;
+        }
+
+      r->_version = EXFC_SHM_VERSION;
+      __atomic_store_n(&r->_magic, EXFC_SHM_MAGIC, __ATOMIC_RELEASE);
+    }
+  else if (!_exfc_shm_wait(&r->_magic, EXFC_SHM_MAGIC)
+           || r->_version != EXFC_SHM_VERSION)
+    {
+      (void)munmap(base, sizeof(exfc_shm_region));
+      return CONDITIONAL;
+    }
+
+  _exfc_shm = r;
+
+  return NORMAL;
+}
+
+void
+exfc_shm_detach()
+{
+  if (_exfc_shm == NULL)
+    {
+      return;
+    }
+
+  (void)munmap(_exfc_shm, sizeof(exfc_shm_region));
+  _exfc_shm = NULL;
+}
+
+int
+exfc_shm_unlink(const char *name)
+{
+  EXFC_FAILS(name, FAILED);
+
+  return ((shm_unlink(name) == 0) ? NORMAL : ABNORMAL);
+}
+
+/* Writer lock must be held; entries cannot change underneath. */
+static int
+_exfc_shm_find_locked(exfc_shm_region *r, const char *name, uint32_t len,
+                      int id)
+{
+  for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+    {
+      const exfc_shm_ent *e = &r->_ent[i];
+
+      if (!e->_used)
+        {
+          continue;
+        }
+
+      if (e->_id == id || (e->_name_len == len
+                           && memcmp(&r->_str[e->_name_off], name, len) == 0))
+        {
+          return i;
+        }
+    }
+  return MISSING;
+}
+
+int
+exfc_shm_addexcep(const char *name, const char *description, int id)
+{
+  EXFC_FAILS(_exfc_shm, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
+  EXFC_FAILS(description, FAILED);
+
+  if (id < 0)
+    {
+      return CONDITIONAL;
+    }
+
+  unsigned long name_len;
+  unsigned long desc_len;
+  EXFC_TRANS(_exfc_buffersize_chk_n(name, &name_len), FAILED);
+  EXFC_TRANS(_exfc_buffersize_chk_n(description, &desc_len), FAILED);
+
+  exfc_shm_region *r = _exfc_shm;
+
+  EXFC_TRANS(_exfc_shm_lock(r), ABNORMAL);
+
+  if (_exfc_shm_find_locked(r, name, (uint32_t)name_len, id) != MISSING)
+    {
+      _exfc_shm_unlock(r);
+      return DUPLICATED;
+    }
+
+  int slot = MISSING;
+  for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+    {
+      if (!r->_ent[i]._used)
+        {
+          slot = i;
+          break;
+        }
+    }
+
+  /* Name & description go in one piece, each followed by '\0'. */
+  exfc_shm_ent ent = {1u, 0, (uint32_t)name_len, 0, (uint32_t)desc_len, id};
+  if (slot == MISSING
+      || _exfc_shm_alloc_str(r, (uint32_t)(name_len + desc_len + 2),
+                             &ent._name_off) != NORMAL)
+    {
+      _exfc_shm_unlock(r);
+      return CONDITIONAL;
+    }
+  ent._desc_off = ent._name_off + (uint32_t)name_len + 1;
+
+  (void)memcpy(&r->_str[ent._name_off], name, name_len);
+  r->_str[ent._name_off + name_len] = '\0';
+  (void)memcpy(&r->_str[ent._desc_off], description, desc_len);
+  r->_str[ent._desc_off + desc_len] = '\0';
+
+  _exfc_shm_write_begin(r);
+  _exfc_shm_store_ent(&r->_ent[slot], &ent);
+  _exfc_shm_write_end(r);
+
+  _exfc_shm_unlock(r);
+
+  return slot;
+}
+
+int
+exfc_shm_removeexcep_byid(int id)
+{
+  EXFC_FAILS(_exfc_shm, ABNORMAL);
+
+  exfc_shm_region *r = _exfc_shm;
+
+  EXFC_TRANS(_exfc_shm_lock(r), ABNORMAL);
+
+  int rtn = MISSING;
+  for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+    {
+      if (r->_ent[i]._used && r->_ent[i]._id == id)
+        {
+          const exfc_shm_ent empty = {0};
+
+          _exfc_shm_write_begin(r);
+          _exfc_shm_store_ent(&r->_ent[i], &empty);
+          _exfc_shm_write_end(r);
+
+          rtn = i;
+          break;
+        }
+    }
+
+  _exfc_shm_unlock(r);
+
+  return rtn;
+}
+
+int
+exfc_shm_getindex_byname(const char *name)
+{
+  EXFC_FAILS(_exfc_shm, ABNORMAL);
+  EXFC_FAILS(name, FAILED);
+
+  exfc_shm_region *r = _exfc_shm;
+
+  /* No name longer than EXCEP_BUFF_MAX was ever added. */
+  const size_t len = strnlen(name, EXCEP_BUFF_MAX + 1);
+  if (len > EXCEP_BUFF_MAX)
+    {
+      return MISSING;
+    }
+
+  for (;;)
+    {
+      const uint32_t s = _exfc_shm_read_begin(r);
+      int rtn = MISSING;
+
+      for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+        {
+          const exfc_shm_ent e = _exfc_shm_load_ent(&r->_ent[i]);
+
+          if (!e._used || e._name_len != len || !_exfc_shm_ent_sane(r, &e))
+            {
+              continue;
+            }
+
+          if (memcmp(&r->_str[e._name_off], name, len) == 0)
+            {
+              rtn = i;
+              break;
+            }
+        }
+
+      if (!_exfc_shm_read_retry(r, s))
+        {
+          return rtn;
+        }
+    }
+}
+
+int
+exfc_shm_getindex_byid(int id)
+{
+  EXFC_FAILS(_exfc_shm, ABNORMAL);
+
+  exfc_shm_region *r = _exfc_shm;
+
+  for (;;)
+    {
+      const uint32_t s = _exfc_shm_read_begin(r);
+      int rtn = MISSING;
+
+      for (register int i = 0; i < EXFC_SHM_ENTRY_MAX; i ++)
+        {
+          if (__atomic_load_n(&r->_ent[i]._used, __ATOMIC_RELAXED)
+              && __atomic_load_n(&r->_ent[i]._id, __ATOMIC_RELAXED) == id)
+            {
+              rtn = i;
+              break;
+            }
+        }
+
+      if (!_exfc_shm_read_retry(r, s))
+        {
+          return rtn;
+        }
+    }
+}
+
+_excep_t
+exfc_shm_get(int idx)
+{
+  if (_exfc_shm == NULL || idx < 0 || idx >= EXFC_SHM_ENTRY_MAX)
+    {
+      return excep_null;
+    }
+
+  exfc_shm_region *r = _exfc_shm;
+  exfc_shm_ent e;
+
+  do
+    {
+      const uint32_t s = _exfc_shm_read_begin(r);
+
+      e = _exfc_shm_load_ent(&r->_ent[idx]);
+
+      if (!_exfc_shm_read_retry(r, s))
+        {
+          break;
+        }
+    }
+  while (true);
+
+  if (!e._used || !_exfc_shm_ent_sane(r, &e))
+    {
+      return excep_null;
+    }
+
+  return ((_excep_t){(char *)&r->_str[e._name_off],
+                     (char *)&r->_str[e._desc_off], e._id});
+}
@@ -0,0 +1,336 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "exfc_binlog.h"
+#include "exfc_signal.h"
+
+#define _EXFC_SIGNAL_LEN 3
+
+static const int _exfc_signal_signo[_EXFC_SIGNAL_LEN] = {
+  SIGSEGV, SIGBUS, SIGFPE
+};
+
+static struct sigaction _exfc_signal_old[_EXFC_SIGNAL_LEN];
+
+static volatile sig_atomic_t _exfc_signal_installed = 0;
+
+/* Stack of the thread calling exfc_signal_install. */
+static char _exfc_signal_stack[EXFC_SIGNAL_STACK_SIZE];
+
+/* Stacks mapped by exfc_signal_thread_init, unmapped as their thread
+   exits. */
+static pthread_key_t _exfc_signal_stack_key;
+static pthread_once_t _exfc_signal_stack_once = PTHREAD_ONCE_INIT;
+static int _exfc_signal_stack_keyed = 0;
+
+/* Reports are formatted here; nothing is allocated once faulted. */
+static __thread char _exfc_signal_buff[EXFC_SIGNAL_BUFF_MAX];
+
+/* Names the allocation site of a faulting address; see
+   exfc_signal_set_site. */
+static exfc_signal_site_fn _exfc_signal_site = NULL;
+
+/* Set while the handler runs, to catch faults inside of itself. */
+static __thread volatile sig_atomic_t _exfc_signal_busy = 0;
+
+static _excep_t _exfc_signal_memory = {
+  "IllegalMemoryAccessException", "Accessed memory illegally.",
+  IllegalMemoryAccessException
+};
+
+static _excep_t _exfc_signal_arithmetic = {
+  "ArithmeticException", "Arithmetic operation faulted.",
+  ArithmeticException
+};
+
+/* Async-signal-safe formatting helpers. */
+static void
+_exfc_signal_puts(char *buff, int *pos, const char *s)
+{
+  while (*s != '\0' && *pos < EXFC_SIGNAL_BUFF_MAX - 1)
+    {
+      buff[(*pos) ++] = *s ++;
+    }
+}
+
+static void
+_exfc_signal_putu(char *buff, int *pos, unsigned long v, unsigned int base)
+{
+  char digits[sizeof(unsigned long) * 8];
+  int n = 0;
+
+  do
+    {
+      digits[n ++] = "0123456789abcdef"[v % base];
+      v /= base;
+    }
+  while (v != 0);
+
+  while (n > 0 && *pos < EXFC_SIGNAL_BUFF_MAX - 1)
+    {
+      buff[(*pos) ++] = digits[-- n];
+    }
+}
+
+static void
+_exfc_signal_handler(int signo, siginfo_t *info, void *uctx)
+{
+  (void)uctx;
+
+  /* Faulted inside of the handler: let the default action happen. */
+  if (_exfc_signal_busy)
+    {
+      (void)signal(signo, SIG_DFL);
+      return;
+    }
+  _exfc_signal_busy = 1;
+
+  _excep_t *except = (signo == SIGFPE)
+                     ? &_exfc_signal_arithmetic : &_exfc_signal_memory;
+
+  const char *file = NULL;
+  const char *function = NULL;
+  const char *what = NULL;
+  long int line = -1;
+
+  const exfc_signal_site_fn site = __atomic_load_n(&_exfc_signal_site,
+                                                   __ATOMIC_ACQUIRE);
+  if (signo != SIGFPE && site != NULL
+      && !site(info->si_addr, &file, &line, &function, &what))
+    {
+      file = NULL;
+      function = NULL;
+      what = NULL;
+      line = -1;
+    }
+
+  exfc_catch *ctx = _exfc_catch_top;
+  if (ctx != NULL)
+    {
+      ctx->_except = *except;
+      ctx->_file = file;
+      ctx->_line = line;
+      ctx->_function = function;
+      ctx->_addr = info->si_addr;
+      ctx->_signo = signo;
+
+      _exfc_signal_busy = 0;
+      _exfc_catch_raise(ctx);
+    }
+
+  char *buff = _exfc_signal_buff;
+  int pos = 0;
+
+  _exfc_signal_puts(buff, &pos, "Threw the ");
+  _exfc_signal_puts(buff, &pos, except->_name);
+  _exfc_signal_puts(buff, &pos, ":\n\tat address 0x");
+  _exfc_signal_putu(buff, &pos, (unsigned long)info->si_addr, 16);
+  _exfc_signal_puts(buff, &pos, ", signal ");
+  _exfc_signal_putu(buff, &pos, (unsigned long)signo, 10);
+  _exfc_signal_puts(buff, &pos, ", code ");
+  _exfc_signal_putu(buff, &pos, (unsigned long)info->si_code, 10);
+  if (what != NULL)
+    {
+      _exfc_signal_puts(buff, &pos, "\n\t");
+      _exfc_signal_puts(buff, &pos, what);
+      _exfc_signal_puts(buff, &pos, " of memory allocated at ");
+      _exfc_signal_puts(buff, &pos, (file == NULL) ? "?" : file);
+      _exfc_signal_puts(buff, &pos, ":");
+      _exfc_signal_putu(buff, &pos, (unsigned long)line, 10);
+      _exfc_signal_puts(buff, &pos, ", func ");
+      _exfc_signal_puts(buff, &pos, (function == NULL) ? "?" : function);
+    }
+  _exfc_signal_puts(buff, &pos, "\n\"");
+  _exfc_signal_puts(buff, &pos, except->_description);
+  _exfc_signal_puts(buff, &pos, "\"\n");
+
+  (void)write(STDERR_FILENO, buff, (size_t)pos);
+
+  /* _exit runs no atexit handlers; write out what would be lost. */
+  _exfc_binlog_flush_signal();
+
+  _exit(except->_id);
+}
+
+static int
+_exfc_signal_altstack(void *sp, size_t size)
+{
+  stack_t ss;
+
+  ss.ss_sp = sp;
+  ss.ss_size = size;
+  ss.ss_flags = 0;
+
+  return ((sigaltstack(&ss, NULL) == 0) ? NORMAL : ABNORMAL);
+}
+
+/* Runs as a thread exits, no longer on the alternate stack. */
+static void
+_exfc_signal_stack_free(void *sp)
+{
+  stack_t ss;
+
+  (void)memset(&ss, 0, sizeof(ss));
+  ss.ss_flags = SS_DISABLE;
+
+  if (sigaltstack(&ss, NULL) == 0)
+    {
+      (void)munmap(sp, EXFC_SIGNAL_STACK_SIZE);
+    }
+}
+
+static void
+_exfc_signal_stack_key_init()
+{
+  _exfc_signal_stack_keyed
+    = (pthread_key_create(&_exfc_signal_stack_key,
+                          _exfc_signal_stack_free) == 0);
+}
+
+/* Touch the thread-local state now, so the handler never causes its lazy
+   allocation. */
+static void
+_exfc_signal_touch_tls()
+{
+  _exfc_signal_busy = 0;
+  (void)*(exfc_catch *volatile *)&_exfc_catch_top;
+}
+
+int
+exfc_signal_thread_init()
+{
+  stack_t cur;
+
+  if (sigaltstack(NULL, &cur) != 0)
+    {
+      return ABNORMAL;
+    }
+
+  if (!(cur.ss_flags & SS_DISABLE))
+    {
+      return DUPLICATED;
+    }
+
+  if (pthread_once(&_exfc_signal_stack_once, _exfc_signal_stack_key_init)
+      != 0 || !_exfc_signal_stack_keyed)
+    {
+      return ABNORMAL;
+    }
+
+  void *sp = mmap(NULL, EXFC_SIGNAL_STACK_SIZE, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (sp == MAP_FAILED)
+    {
+      return ABNORMAL;
+    }
+
+  if (_exfc_signal_altstack(sp, EXFC_SIGNAL_STACK_SIZE) != NORMAL)
+    {
+      (void)munmap(sp, EXFC_SIGNAL_STACK_SIZE);
+      return ABNORMAL;
+    }
+
+  /* Unmapped by _exfc_signal_stack_free once the thread exits. */
+  if (pthread_setspecific(_exfc_signal_stack_key, sp) != 0)
+    {
+      _exfc_signal_stack_free(sp);
+      return ABNORMAL;
+    }
+
+  _exfc_signal_touch_tls();
+
+  return NORMAL;
+}
+
+int
+exfc_signal_install()
+{
+  if (_exfc_signal_installed)
+    {
+      return DUPLICATED;
+    }
+
+  if (_exfc_signal_altstack(_exfc_signal_stack, sizeof(_exfc_signal_stack))
+      != NORMAL)
+    {
+      return ABNORMAL;
+    }
+
+  _exfc_signal_touch_tls();
+
+  struct sigaction sa;
+  (void)memset(&sa, 0, sizeof(sa));
+  sa.sa_sigaction = _exfc_signal_handler;
+  /* SA_NODEFER: the handler may leave through siglongjmp, which does not
+     restore the signal mask, see EXFC_TRY. */
+  sa.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_NODEFER;
+  (void)sigemptyset(&sa.sa_mask);
+
+  for (register int i = 0; i < _EXFC_SIGNAL_LEN; i ++)
+    {
+      if (sigaction(_exfc_signal_signo[i], &sa, &_exfc_signal_old[i]) != 0)
+        {
+          /* Roll back the ones installed. */
+          while (-- i >= 0)
+            {
+              (void)sigaction(_exfc_signal_signo[i], &_exfc_signal_old[i],
+                              NULL);
+            }
+          return ABNORMAL;
+        }
+    }
+
+  _exfc_signal_installed = 1;
+
+  return NORMAL;
+}
+
+int
+exfc_signal_uninstall()
+{
+  if (!_exfc_signal_installed)
+    {
+      return MISSING;
+    }
+
+  for (register int i = 0; i < _EXFC_SIGNAL_LEN; i ++)
+    {
+      (void)sigaction(_exfc_signal_signo[i], &_exfc_signal_old[i], NULL);
+    }
+
+  _exfc_signal_installed = 0;
+
+  return NORMAL;
+}
+
+void
+exfc_signal_set_site(exfc_signal_site_fn fn)
+{
+  __atomic_store_n(&_exfc_signal_site, fn, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,74 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_site.c
+ * @brief Per-site cached THROW.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include "exfc_site.h"
+
+unsigned int _exfc_registry_gen = 0;
+
+static _excep_t _exfc_site_unknown = {
+  "UnknownException", "Threw an exception NOT registered.", UnknownException
+};
+
+/* Store IDX found in generation GEN. */
+static const _excep_t *
+_exfc_site_store(exfc_site_cache *cache, unsigned int gen, int idx)
+{
+  if (idx < 0)
+    {
+      return NULL;
+    }
+
+  __atomic_store_n(&cache->_word,
+                   ((uint64_t)gen << 32) | (uint32_t)(idx + 1),
+                   __ATOMIC_RELAXED);
+
+  return _exfc_getexcep(idx);
+}
+
+const _excep_t *
+_exfc_site_resolve_byid(exfc_site_cache *cache, int id)
+{
+  /* Read before looking up: a change meanwhile leaves the entry stale. */
+  const unsigned int gen = __atomic_load_n(&_exfc_registry_gen,
+                                           __ATOMIC_ACQUIRE);
+
+  return _exfc_site_store(cache, gen, exfc_getindex_byid(id));
+}
+
+const _excep_t *
+_exfc_site_resolve_byname(exfc_site_cache *cache, const char *name)
+{
+  EXFC_FAILS(name, NULL);
+
+  const unsigned int gen = __atomic_load_n(&_exfc_registry_gen,
+                                           __ATOMIC_ACQUIRE);
+
+  return _exfc_site_store(cache, gen, exfc_getindex_byname(name));
+}
+
+int
+_exfc_site_throw_missing(const char *file, long int line,
+                         const char *function)
+{
+  return _exfc_throw(&_exfc_site_unknown, file, line, function, NULL);
+}
@@ -0,0 +1,190 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <sched.h>
+#include <string.h>
+
+#include "exfc_task.h"
+
+/* Task running on current thread, for exfc_task_payload. */
+static __thread exfc_task *_exfc_task_current = NULL;
+
+/* Task exfc_task_join throws again on current thread, for
+   _exfc_task_take_payload. */
+static __thread const exfc_task *_exfc_task_joined = NULL;
+
+int
+exfc_task_init(exfc_task *task, exfc_task_fn fn, void *arg)
+{
+  EXFC_FAILS(task, FAILED);
+  EXFC_FAILS(fn, FAILED);
+
+  task->_fn = fn;
+  task->_arg = arg;
+  task->_rtn = 0;
+  task->_except = excep_null;
+  task->_file = NULL;
+  task->_function = NULL;
+  task->_line = -1;
+  task->_cause_len = 0;
+  task->_payload_len = 0;
+  __atomic_store_n(&task->_state, EXFC_TASK_PENDING, __ATOMIC_RELAXED);
+
+  return NORMAL;
+}
+
+int
+exfc_task_run(exfc_task *task)
+{
+  EXFC_FAILS(task, FAILED);
+
+  exfc_task *outer = _exfc_task_current;
+  _exfc_task_current = task;
+  task->_payload_len = 0;
+
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      task->_rtn = task->_fn(task->_arg);
+      exfc_catch_pop(&c);
+
+      /* Attached to nothing thrown. */
+      task->_payload_len = 0;
+
+      _exfc_task_current = outer;
+      __atomic_store_n(&task->_state, EXFC_TASK_DONE, __ATOMIC_RELEASE);
+
+      return EXFC_TASK_DONE;
+    }
+
+  task->_except = c._except;
+  task->_file = c._file;
+  task->_line = c._line;
+  task->_function = c._function;
+
+  /* Causes live in the pool of this thread; copy them out. */
+  unsigned int n = 0;
+  for (exfc_cause *cause = c._cause;
+       cause != NULL && n < EXFC_TASK_CAUSE_MAX; cause = cause->_next)
+    {
+      task->_cause[n] = *cause;
+      task->_cause[n]._next = NULL;
+      n += 1;
+    }
+  task->_cause_len = n;
+  exfc_chain_clear();
+
+  _exfc_task_current = outer;
+  __atomic_store_n(&task->_state, EXFC_TASK_THROWN, __ATOMIC_RELEASE);
+
+  return EXFC_TASK_THROWN;
+}
+
+int
+exfc_task_payload(const void *data, size_t len)
+{
+  exfc_task *task = _exfc_task_current;
+
+  if (task == NULL)
+    {
+      return MISSING;
+    }
+
+  if (data == NULL)
+    {
+      len = 0;
+    }
+
+  if (len > EXFC_TASK_PAYLOAD_MAX)
+    {
+      len = EXFC_TASK_PAYLOAD_MAX;
+    }
+
+  (void)memcpy(task->_payload, data, len);
+  task->_payload_len = len;
+
+  return NORMAL;
+}
+
+uint32_t
+exfc_task_wait(const exfc_task *task)
+{
+  uint32_t state;
+
+  while ((state = exfc_task_state(task)) == EXFC_TASK_PENDING)
+    {
+      (void)sched_yield();
+    }
+  return state;
+}
+
+int
+exfc_task_join(exfc_task *task)
+{
+  EXFC_FAILS(task, FAILED);
+
+  const uint32_t state = exfc_task_state(task);
+
+  if (state == EXFC_TASK_PENDING)
+    {
+      return CONDITIONAL;
+    }
+
+  if (EXFC_LIKELY(state == EXFC_TASK_DONE))
+    {
+      return task->_rtn;
+    }
+
+  /* Rebuild the chain on this thread, oldest cause first. */
+  exfc_chain_clear();
+  for (unsigned int i = task->_cause_len; i > 0; i --)
+    {
+      const exfc_cause *cause = &task->_cause[i - 1];
+
+      (void)_exfc_chain_push_site(&cause->_except, cause->_file,
+                                  cause->_line, cause->_function);
+    }
+  _exfc_chain_set_keep();
+  _exfc_task_joined = task;
+
+  (void)_exfc_throw(&task->_except, task->_file, task->_line,
+                    task->_function, NULL);
+
+  return ABNORMAL;
+}
+
+size_t
+_exfc_task_take_payload(const void **data)
+{
+  const exfc_task *task = _exfc_task_joined;
+
+  _exfc_task_joined = NULL;
+  if (task == NULL || task->_payload_len == 0)
+    {
+      *data = NULL;
+      return 0;
+    }
+
+  *data = task->_payload;
+  return task->_payload_len;
+}
@@ -0,0 +1,151 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "exfc_binlog.h"
+#include "exfc_catch.h"
+#include "exfc_chain.h"
+#include "exfc_emerg.h"
+#include "exfc_handler.h"
+#include "exfc_prof.h"
+#include "exfc_task.h"
+
+int
+_exfc_throw(_excep_t *except, const char *__restrict__ file, long int line,
+            const char *__restrict__ function, const char *__restrict__ fmt)
+{
+  /* Nothing below may allocate for these; give the reserve back first. */
+  const bool emerg = _exfc_emerg_is(except);
+  if (emerg)
+    {
+      _exfc_emerg_enter(except);
+    }
+
+  /* A THROW without cause starts a new chain. */
+  if (!_exfc_chain_take_keep())
+    {
+      exfc_chain_clear();
+    }
+
+  /* Only a task thrown again by exfc_task_join carries a payload. */
+  const void *payload = NULL;
+  const size_t payload_len = _exfc_task_take_payload(&payload);
+
+  /* Every throw is logged, caught or not. */
+  const bool binlog = exfc_binlog_enabled();
+  if (binlog)
+    {
+      (void)exfc_binlog_record(except, file, line, function, NULL, 0);
+    }
+
+  _exfc_prof_tick(except, function);
+
+  const exfc_policy policy = _exfc_handler_dispatch(except, file, line,
+                                                    function);
+  switch (policy)
+    {
+    case EXFC_POLICY_IGNORE:
+    case EXFC_POLICY_RETRY:
+      return policy;
+    case EXFC_POLICY_LOG:
+    case EXFC_POLICY_ABORT:
+      if (emerg)
+        {
+          _exfc_emerg_report(except, file, line, function);
+        }
+      else
+        {
+          (void)fprintf(stderr, EXCEPT_FMT, except->_name, file, line,
+                        function, except->_description);
+        }
+      if (policy == EXFC_POLICY_LOG)
+        {
+          return policy;
+        }
+
+      /* abort() runs no atexit handlers; write out what would be lost. */
+      if (binlog)
+        {
+          (void)exfc_binlog_flush();
+        }
+      (void)fflush(NULL);
+      abort();
+    default:
+      break;
+    }
+
+  /* Hand over to the innermost catch context, once there is one. */
+  exfc_catch *ctx = _exfc_catch_top;
+  if (ctx != NULL)
+    {
+      ctx->_except = *except;
+      ctx->_file = file;
+      ctx->_line = line;
+      ctx->_function = function;
+      ctx->_cause = exfc_chain_head();
+      ctx->_payload = payload;
+      ctx->_payload_len = payload_len;
+
+      _exfc_catch_raise(ctx);
+    }
+
+  /* Ignore $fmt when outputting the exception title.
+     Use EXCEPT_FMT instead. */
+  (void)fmt;
+
+  /* The log has the record already; the report still goes to stderr. */
+  if (binlog)
+    {
+      (void)exfc_binlog_flush();
+    }
+
+  if (emerg)
+    {
+      _exfc_emerg_report(except, file, line, function);
+      exit(except->_id);
+    }
+
+  (void)fprintf(stderr, ((file == NULL && line == -1 && function == NULL)
+                         ? DEF_EXCEPT_FMT
+                         : EXCEPT_FMT), except->_name, file, line, function,
+                                        except->_description);
+
+  for (exfc_cause *c = exfc_chain_head(); c != NULL; c = c->_next)
+    {
+      (void)fprintf(stderr, CAUSE_FMT, c->_except._name, c->_file, c->_line,
+                    c->_function, c->_except._description);
+    }
+
+  if (exfc_chain_dropped() > 0)
+    {
+      (void)fprintf(stderr, "\t... %u more causes dropped\n",
+                    exfc_chain_dropped());
+    }
+
+  exit(except->_id);  // Try using memctl (credit: Wilhelm-Lee@github.com) to
+                      // solve such issues by retracing back to caller.
+                      // Direct usage of exit(int):void is NOT recommanded. It
+                      // damages thead-safe in long-term consideration.
+}
@@ -1,24 +1,722 @@
+#define _DEFAULT_SOURCE 1
+
+#include <sched.h>
 #include <stdlib.h>
-#include "../../ExFC/src/exfc.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "exfc.h"
+#include "exfc_emerg.h"
+#include "exfc_signal.h"
 #include "memctrl.h"
 
 #define AUTO_MEM_CTRL 1
 
+void *MEMCTRL_STACK[MAX_MEMCTRL_STACK] = {0};
+uint16_t MEMCTRL_STACK_SITE[MAX_MEMCTRL_STACK] = {0};
+size_t MEMCTRL_STACK_SIZE[MAX_MEMCTRL_STACK] = {0};
+
+bool __MEMCTRL_STATUS_LOCK = false;
+
+void **_memctrl_p = MEMCTRL_STACK;
+
+static unsigned int _memctrl_len = 0;
+static uint32_t _memctrl_lock = 0;
+
+/* Site table, open addressing on (file, line, caller). Slot 0 is kept for
+   the unknown site. */
+static memctrl_site _memctrl_sites[MAX_MEMCTRL_SITE];
+static bool _memctrl_site_used[MAX_MEMCTRL_SITE];
+
+/*
+   Guarded pool: MAX_MEMCTRL_GUARD data pages, each between two PROT_NONE
+   guard pages:
+
+   [guard][slot 0][guard][slot 1][guard] ... [slot n - 1][guard]
+
+   An allocation ends flush with the guard page after its slot, so
+   overflowing it faults; within MEMCTRL_GUARD_ALIGN - 1 bytes once that
+   was raised above 1. A freed slot is made PROT_NONE too, and slots are
+   reused round-robin, which keeps freed memory poisoned as long as
+   possible.
+*/
+
+#define _MEMCTRL_GUARD_FREE 0
+#define _MEMCTRL_GUARD_LIVE 1
+#define _MEMCTRL_GUARD_FREED 2
+
+typedef struct _memctrl_guard_slot_S
+{
+  char *_addr;
+  size_t _size;
+  const char *_file;
+  const char *_function;
+  long int _line;
+  int _state;
+} _memctrl_guard_slot;
+
+static char *_memctrl_guard_pool = NULL;
+static size_t _memctrl_guard_page = 0;
+static unsigned int _memctrl_guard_rate = 0;
+static unsigned int _memctrl_guard_next = 0;
+static _memctrl_guard_slot _memctrl_guard_slots[MAX_MEMCTRL_GUARD];
+
+static __thread unsigned int _memctrl_guard_countdown = 0;
+
+static void
+_memctrl_acquire()
+{
+  while (__atomic_exchange_n(&_memctrl_lock, 1u, __ATOMIC_ACQUIRE) != 0)
+    {
+      (void)sched_yield();
+    }
+}
+
+static void
+_memctrl_release()
+{
+  __atomic_store_n(&_memctrl_lock, 0u, __ATOMIC_RELEASE);
+}
+
+/* Index of the site, added once new; 0 once the table was full.
+   Called with the lock held. */
+static uint16_t
+_memctrl_site_of(const char *file, long int line, const char *function,
+                 void *caller)
+{
+  uint64_t h = 14695981039346656037u;
+  h = (h ^ (uint64_t)(uintptr_t)file) * 1099511628211u;
+  h = (h ^ (uint64_t)line) * 1099511628211u;
+  h = (h ^ (uint64_t)(uintptr_t)caller) * 1099511628211u;
+
+  for (register unsigned int i = 0; i < MAX_MEMCTRL_SITE; i ++)
+    {
+      const unsigned int slot = (unsigned int)(h + i) & (MAX_MEMCTRL_SITE - 1);
+      if (slot == 0)
+        {
+          continue;
+        }
+
+      memctrl_site *s = &_memctrl_sites[slot];
+      if (!_memctrl_site_used[slot])
+        {
+          s->_file = file;
+          s->_line = line;
+          s->_function = function;
+          s->_caller = caller;
+          _memctrl_site_used[slot] = true;
+          return (uint16_t)slot;
+        }
+
+      if (s->_file == file && s->_line == line && s->_caller == caller)
+        {
+          return (uint16_t)slot;
+        }
+    }
+
+  return 0;
+}
+
+/* Drop the entry at IDX, keeping the order of those above it.
+   Called with the lock held. */
+static void
+_memctrl_drop(unsigned int idx)
+{
+  const size_t n = _memctrl_len - idx - 1;
+
+  (void)memmove(&MEMCTRL_STACK[idx], &MEMCTRL_STACK[idx + 1],
+                n * sizeof(MEMCTRL_STACK[0]));
+  (void)memmove(&MEMCTRL_STACK_SITE[idx], &MEMCTRL_STACK_SITE[idx + 1],
+                n * sizeof(MEMCTRL_STACK_SITE[0]));
+  (void)memmove(&MEMCTRL_STACK_SIZE[idx], &MEMCTRL_STACK_SIZE[idx + 1],
+                n * sizeof(MEMCTRL_STACK_SIZE[0]));
+
+  _memctrl_len --;
+  MEMCTRL_STACK[_memctrl_len] = NULL;
+}
+
+void
+memctrl_initmemstk()
+{
+  /* Lock up status */
+  __MEMCTRL_STATUS_LOCK = true;
+
+  /* Initialise memstack */
+  _memctrl_acquire();
+  (void)memset(MEMCTRL_STACK, 0, sizeof(MEMCTRL_STACK));
+  _memctrl_len = 0;
+  _memctrl_p = MEMCTRL_STACK;
+  _memctrl_release();
+
+  /* Headroom for whoever catches OutOfMemoryException. */
+  (void)exfc_emerg_init(EXFC_EMERG_RESERVE);
+}
+
+void
+_memctrl_push_site(void *addr, size_t size, const char *file, long int line,
+                   const char *function, void *caller)
+{
+  _memctrl_acquire();
+
+  if (_memctrl_len == MAX_MEMCTRL_STACK)
+    {
+      _memctrl_release();
+      (void)THROW(&(_excep_t){"OutOfBoundException", "memctrl stack was full",
+                              OutOfBoundException},
+                  file, line, function, NULL);
+      return;
+    }
+
+  MEMCTRL_STACK[_memctrl_len] = addr;
+  MEMCTRL_STACK_SIZE[_memctrl_len] = size;
+  MEMCTRL_STACK_SITE[_memctrl_len] = (file == NULL
+                                      ? 0
+                                      : _memctrl_site_of(file, line,
+                                                         function, caller));
+  _memctrl_len ++;
+
+  _memctrl_release();
+}
+
 void
 memctrl_push(void *addr)
 {
-  if (memctrl_stkfull())
-    THROW(StackOverflowException, __FILE__, __LINE__, __FUNCTION__, EXCEP_FMT);
+  _memctrl_push_site(addr, 0, NULL, -1, NULL, NULL);
+}
+
+/* Slot holding ADDR, -1 once outside of every slot & guard page. */
+static int
+_memctrl_guard_slot_of(const void *addr, bool *guard)
+{
+  const char *pool = __atomic_load_n(&_memctrl_guard_pool, __ATOMIC_ACQUIRE);
+  if (pool == NULL || (const char *)addr < pool)
+    {
+      return -1;
+    }
+
+  const size_t page = ((size_t)((const char *)addr - pool)
+                       / _memctrl_guard_page);
+  if (page > 2 * MAX_MEMCTRL_GUARD)
+    {
+      return -1;
+    }
+
+  *guard = (page % 2 == 0);
+  if (!*guard)
+    {
+      return (int)(page / 2);
+    }
+
+  /* A guard page: blame the slot before it, being overflowed, unless it
+     was not live; then the one after it, being underflowed. */
+  const int before = (int)(page / 2) - 1;
+  if (before >= 0
+      && _memctrl_guard_slots[before]._state == _MEMCTRL_GUARD_LIVE)
+    {
+      return before;
+    }
+
+  return ((page / 2 < MAX_MEMCTRL_GUARD) ? (int)(page / 2) : before);
+}
+
+/* Looked up by the fault handler; async-signal-safe. */
+static bool
+_memctrl_guard_site(void *addr, const char **file, long int *line,
+                    const char **function, const char **what)
+{
+  bool guard = false;
+  const int slot = _memctrl_guard_slot_of(addr, &guard);
+  if (slot < 0)
+    {
+      return false;
+    }
+
+  const _memctrl_guard_slot *s = &_memctrl_guard_slots[slot];
+  if (s->_state == _MEMCTRL_GUARD_FREE)
+    {
+      return false;
+    }
+
+  *file = s->_file;
+  *line = s->_line;
+  *function = s->_function;
+
+  if (s->_state == _MEMCTRL_GUARD_FREED)
+    {
+      *what = "Use after free";
+    }
+  else
+    {
+      *what = ((char *)addr < s->_addr) ? "Underflow" : "Overflow";
+    }
+
+  return true;
+}
+
+int
+memctrl_guard_init(unsigned int rate)
+{
+  if (__atomic_load_n(&_memctrl_guard_pool, __ATOMIC_ACQUIRE) == NULL)
+    {
+      const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+      void *pool = mmap(NULL, page * (2 * MAX_MEMCTRL_GUARD + 1), PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (pool == MAP_FAILED)
+        {
+          return ABNORMAL;
+        }
+
+      _memctrl_acquire();
+      if (_memctrl_guard_pool == NULL)
+        {
+          _memctrl_guard_page = page;
+          __atomic_store_n(&_memctrl_guard_pool, (char *)pool,
+                           __ATOMIC_RELEASE);
+          pool = NULL;
+        }
+      _memctrl_release();
+
+      /* Lost the race to another thread. */
+      if (pool != NULL)
+        {
+          (void)munmap(pool, page * (2 * MAX_MEMCTRL_GUARD + 1));
+        }
+
+      exfc_signal_set_site(_memctrl_guard_site);
+    }
+
+  __atomic_store_n(&_memctrl_guard_rate, rate, __ATOMIC_RELEASE);
+
+  return NORMAL;
+}
+
+int
+memctrl_guard_begin(unsigned int rate)
+{
+  if (memctrl_guard_init(rate) != NORMAL)
+    {
+      return ABNORMAL;
+    }
+
+  return (exfc_signal_install() == ABNORMAL ? ABNORMAL : NORMAL);
 }
 
 bool
-memctrl_stkfull()
+memctrl_guarded(const void *addr)
+{
+  bool guard;
+
+  return (_memctrl_guard_slot_of(addr, &guard) >= 0);
+}
+
+/* Whether current allocation is to be guarded. One relaxed load & one
+   branch while sampling is off. */
+static inline bool
+_memctrl_guard_sample()
+{
+  const unsigned int rate = __atomic_load_n(&_memctrl_guard_rate,
+                                            __ATOMIC_RELAXED);
+  if (EXFC_LIKELY(rate == 0))
+    {
+      return false;
+    }
+
+  if (_memctrl_guard_countdown > 1)
+    {
+      _memctrl_guard_countdown --;
+      return false;
+    }
+  _memctrl_guard_countdown = rate;
+
+  return true;
+}
+
+/* Guarded memory of SIZE bytes; NULL once too large or out of slots, for
+   malloc to take over. */
+static void *
+_memctrl_guard_alloc(size_t size, const char *file, long int line,
+                     const char *function)
 {
-  return (memctrl_stklen() == MAX_MEMCTRL_STACK);
+  if (size == 0)
+    {
+      return NULL;
+    }
+
+  /* Flush with the guard page, see MEMCTRL_GUARD_ALIGN. */
+  size_t align = size & -size;
+  if (align > 16)
+    {
+      align = 16;
+    }
+  if (align < MEMCTRL_GUARD_ALIGN)
+    {
+      align = MEMCTRL_GUARD_ALIGN;
+    }
+  const size_t span = (size + align - 1) & ~(align - 1);
+  if (span < size || span > _memctrl_guard_page)
+    {
+      return NULL;
+    }
+
+  void *addr = NULL;
+
+  _memctrl_acquire();
+  for (register unsigned int i = 0; i < MAX_MEMCTRL_GUARD; i ++)
+    {
+      const unsigned int k = (_memctrl_guard_next + i) % MAX_MEMCTRL_GUARD;
+      _memctrl_guard_slot *s = &_memctrl_guard_slots[k];
+      if (s->_state == _MEMCTRL_GUARD_LIVE)
+        {
+          continue;
+        }
+
+      char *data = _memctrl_guard_pool + _memctrl_guard_page * (2 * k + 1);
+      if (mprotect(data, _memctrl_guard_page, PROT_READ | PROT_WRITE) != 0)
+        {
+          break;
+        }
+
+      s->_addr = data + (_memctrl_guard_page - span);
+      s->_size = size;
+      s->_file = file;
+      s->_line = line;
+      s->_function = function;
+      s->_state = _MEMCTRL_GUARD_LIVE;
+
+      _memctrl_guard_next = k + 1;
+      addr = s->_addr;
+      break;
+    }
+  _memctrl_release();
+
+  return addr;
+}
+
+/* Poison guarded ADDR. Returns false once ADDR was not guarded. */
+static bool
+_memctrl_guard_free(void *addr)
+{
+  bool guard = false;
+  const int slot = _memctrl_guard_slot_of(addr, &guard);
+  if (slot < 0)
+    {
+      return false;
+    }
+
+  _memctrl_acquire();
+  _memctrl_guard_slot *s = &_memctrl_guard_slots[slot];
+  const bool live = (s->_state == _MEMCTRL_GUARD_LIVE
+                     && s->_addr == (char *)addr);
+  if (live)
+    {
+      (void)mprotect(_memctrl_guard_pool
+                     + _memctrl_guard_page * (2 * (size_t)slot + 1),
+                     _memctrl_guard_page, PROT_NONE);
+      s->_state = _MEMCTRL_GUARD_FREED;
+    }
+  _memctrl_release();
+
+  if (!live)
+    {
+      (void)THROW(&(_excep_t){"IllegalMemoryAccessException",
+                              "Freed guarded memory twice, or not from its "
+                              "beginning.", IllegalMemoryAccessException},
+                  s->_file, s->_line, s->_function, NULL);
+    }
+
+  return true;
+}
+
+void *
+_memctrl_malloc_site(size_t size, const char *file, long int line,
+                     const char *function, void *caller)
+{
+  void *addr = NULL;
+  if (EXFC_UNLIKELY(_memctrl_guard_sample()))
+    {
+      addr = _memctrl_guard_alloc(size, file, line, function);
+    }
+
+  if (addr == NULL)
+    {
+      addr = malloc(size);
+    }
+
+  if (addr == NULL)
+    {
+      (void)THROW(&exfc_emerg_oom, file, line, function, NULL);
+      return NULL;
+    }
+
+  _memctrl_push_site(addr, size, file, line, function, caller);
+
+  return addr;
+}
+
+/* Size of live guarded ADDR; 0 once not one. */
+static size_t
+_memctrl_guard_size(void *addr)
+{
+  bool guard = false;
+  const int slot = _memctrl_guard_slot_of(addr, &guard);
+  if (slot < 0)
+    {
+      return 0;
+    }
+
+  size_t size = 0;
+
+  _memctrl_acquire();
+  const _memctrl_guard_slot *s = &_memctrl_guard_slots[slot];
+  if (s->_state == _MEMCTRL_GUARD_LIVE && s->_addr == (char *)addr)
+    {
+      size = s->_size;
+    }
+  _memctrl_release();
+
+  return size;
+}
+
+void *
+_memctrl_realloc_site(void *addr, size_t size, const char *file,
+                      long int line, const char *function, void *caller)
+{
+  if (addr == NULL)
+    {
+      return _memctrl_malloc_site(size, file, line, function, caller);
+    }
+
+  if (size == 0)
+    {
+      memctrl_free(addr);
+      return NULL;
+    }
+
+  void *moved = NULL;
+  if (memctrl_guarded(addr))
+    {
+      const size_t old = _memctrl_guard_size(addr);
+
+      /* Not malloc's; move it, which also keeps it guarded at random. */
+      moved = _memctrl_malloc_site(size, file, line, function, caller);
+      if (moved == NULL)
+        {
+          return NULL;
+        }
+
+      (void)memcpy(moved, addr, (old < size ? old : size));
+      memctrl_free(addr);
+      return moved;
+    }
+
+  /* Only its value is needed past realloc, to find its entry. */
+  const uintptr_t was = (uintptr_t)addr;
+  moved = realloc(addr, size);
+  if (moved == NULL)
+    {
+      (void)THROW(&exfc_emerg_oom, file, line, function, NULL);
+      return NULL;
+    }
+
+  (void)memctrl_remove((void *)was);
+  _memctrl_push_site(moved, size, file, line, function, caller);
+
+  return moved;
+}
+
+void
+memctrl_pop()
+{
+  _memctrl_acquire();
+  if (_memctrl_len > 0)
+    {
+      _memctrl_drop(_memctrl_len - 1);
+    }
+  _memctrl_release();
+}
+
+bool
+memctrl_remove(void *addr)
+{
+  bool found = false;
+
+  _memctrl_acquire();
+  /* Recent allocations are the likeliest to be freed. */
+  for (register int i = (int)_memctrl_len - 1; i >= 0; i --)
+    {
+      if (MEMCTRL_STACK[i] == addr)
+        {
+          _memctrl_drop((unsigned int)i);
+          found = true;
+          break;
+        }
+    }
+  _memctrl_release();
+
+  return found;
+}
+
+void
+memctrl_free(void *addr)
+{
+  (void)memctrl_remove(addr);
+
+  if (!_memctrl_guard_free(addr))
+    {
+      free(addr);
+    }
+}
+
+bool
+memctrl_empty()
+{
+  return (__atomic_load_n(&_memctrl_len, __ATOMIC_RELAXED) == 0);
+}
+
+bool
+memctrl_full()
+{
+  return (__atomic_load_n(&_memctrl_len, __ATOMIC_RELAXED)
+          == MAX_MEMCTRL_STACK);
+}
+
+bool
+memctrl_exist(void *addr)
+{
+  bool found = false;
+
+  _memctrl_acquire();
+  for (register unsigned int i = 0; i < _memctrl_len; i ++)
+    {
+      if (MEMCTRL_STACK[i] == addr)
+        {
+          found = true;
+          break;
+        }
+    }
+  _memctrl_release();
+
+  return found;
+}
+
+void
+_memctrl_mvp(unsigned int idx)
+{
+  if (idx < MAX_MEMCTRL_STACK)
+    {
+      _memctrl_p = &MEMCTRL_STACK[idx];
+    }
+}
+
+void *
+_memctrl_get()
+{
+  return *_memctrl_p;
+}
+
+void
+_memctrl_set(void *addr)
+{
+  *_memctrl_p = addr;
+}
+
+/* Totals of one site, for memctrl_report. */
+typedef struct _memctrl_total_S
+{
+  size_t _bytes;
+  unsigned int _count;
+  uint16_t _site;
+} _memctrl_total;
+
+static int
+_memctrl_total_cmp(const void *a, const void *b)
+{
+  const _memctrl_total *x = a;
+  const _memctrl_total *y = b;
+
+  if (x->_bytes != y->_bytes)
+    {
+      return (x->_bytes < y->_bytes ? 1 : -1);
+    }
+
+  return ((int)y->_count - (int)x->_count);
 }
 
 int
-memctrl_stklen()
+memctrl_report(FILE *stream)
+{
+  EXFC_FAILS(stream, FAILED);
+
+  static _memctrl_total totals[MAX_MEMCTRL_SITE];
+  size_t bytes = 0;
+
+  _memctrl_acquire();
+
+  (void)memset(totals, 0, sizeof(totals));
+  for (register unsigned int i = 0; i < _memctrl_len; i ++)
+    {
+      _memctrl_total *t = &totals[MEMCTRL_STACK_SITE[i]];
+      t->_site = MEMCTRL_STACK_SITE[i];
+      t->_bytes += MEMCTRL_STACK_SIZE[i];
+      t->_count ++;
+      bytes += MEMCTRL_STACK_SIZE[i];
+    }
+  const unsigned int live = _memctrl_len;
+
+  /* Pack the sites with live allocations to the front. */
+  int sites = 0;
+  for (register int i = 0; i < MAX_MEMCTRL_SITE; i ++)
+    {
+      if (totals[i]._count > 0)
+        {
+          totals[sites ++] = totals[i];
+        }
+    }
+  qsort(totals, (size_t)sites, sizeof(totals[0]), _memctrl_total_cmp);
+
+  if (live > 0)
+    {
+      (void)fprintf(stream, "memctrl: %u live allocations, %zu bytes, "
+                            "from %d sites\n", live, bytes, sites);
+    }
+
+  for (register int i = 0; i < sites; i ++)
+    {
+      const memctrl_site *s = &_memctrl_sites[totals[i]._site];
+      if (totals[i]._site == 0)
+        {
+          (void)fprintf(stream, "\t%zu bytes in %u allocations "
+                                "at unknown site\n",
+                        totals[i]._bytes, totals[i]._count);
+          continue;
+        }
+
+      (void)fprintf(stream, "\t%zu bytes in %u allocations at %s:%ld, "
+                            "func %s",
+                    totals[i]._bytes, totals[i]._count, s->_file, s->_line,
+                    s->_function);
+      if (s->_caller != NULL)
+        {
+          (void)fprintf(stream, ", called from %p", s->_caller);
+        }
+      (void)fputc('\n', stream);
+    }
+
+  _memctrl_release();
+
+  return sites;
+}
+
+void
+memctrl_resetmemstk()
 {
-  memlen()
+  (void)memctrl_report(stderr);
+
+  _memctrl_acquire();
+  (void)memset(MEMCTRL_STACK, 0, sizeof(MEMCTRL_STACK[0]) * _memctrl_len);
+  _memctrl_len = 0;
+  _memctrl_p = MEMCTRL_STACK;
+  _memctrl_release();
+
+  __MEMCTRL_STATUS_LOCK = false;
 }
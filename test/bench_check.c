@@ -0,0 +1,122 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file bench_check.c
+ * @brief Time of EXFC_FAILS & EXFC_TRANS against the plain if-return form
+ *        of "fails" & "trans" they replaced, on the path where no check
+ *        fails.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "exfc_check.h"
+
+#ifndef BENCH_ROUNDS
+# define BENCH_ROUNDS 200000000L
+#endif /* NO BENCH_ROUNDS */
+
+#define BENCH_FAILED (-400)
+
+/* As "fails" & "trans" were. */
+#define OLD_FAILS(ptr, rtn)                                                   \
+  if ((ptr) == NULL)                                                          \
+    return (rtn)
+
+#define OLD_TRANS(val, rtn)                                                   \
+  if ((val) == (rtn))                                                         \
+    return (rtn)
+
+typedef int (*bench_fn)(const int *a, const int *b, int v);
+
+static __attribute__((noinline)) int
+bench_old(const int *a, const int *b, int v)
+{
+  OLD_FAILS(a, BENCH_FAILED);
+  OLD_FAILS(b, BENCH_FAILED);
+  OLD_TRANS(v, BENCH_FAILED);
+  OLD_TRANS(*a, BENCH_FAILED);
+
+  return (*a + *b + v);
+}
+
+static __attribute__((noinline)) int
+bench_new(const int *a, const int *b, int v)
+{
+  EXFC_FAILS(a, BENCH_FAILED);
+  EXFC_FAILS(b, BENCH_FAILED);
+  EXFC_TRANS(v, BENCH_FAILED);
+  EXFC_TRANS(*a, BENCH_FAILED);
+
+  return (*a + *b + v);
+}
+
+/* Nanoseconds per call of FN. */
+static double
+bench_run(bench_fn fn)
+{
+  /* Through a volatile pointer, so calls are neither inlined nor hoisted. */
+  bench_fn volatile call = fn;
+  const int a = 1;
+  const int b = 2;
+  long int sum = 0;
+  struct timespec t0;
+  struct timespec t1;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (register long int i = 0; i < BENCH_ROUNDS; i ++)
+    {
+      sum += call(&a, &b, (int)(i & 0xff));
+    }
+  (void)clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  if (sum < 0)
+    {
+      (void)fprintf(stderr, "bench_check: a check failed\n");
+      exit(1);
+    }
+
+  return ((double)(t1.tv_sec - t0.tv_sec) * 1e9
+          + (double)(t1.tv_nsec - t0.tv_nsec)) / (double)BENCH_ROUNDS;
+}
+
+int
+main()
+{
+  /* Warm up, then take the best of three. */
+  (void)bench_run(bench_old);
+  (void)bench_run(bench_new);
+
+  double old = 1e30;
+  double new = 1e30;
+  for (register int i = 0; i < 3; i ++)
+    {
+      const double o = bench_run(bench_old);
+      const double n = bench_run(bench_new);
+      old = (o < old ? o : old);
+      new = (n < new ? n : new);
+    }
+
+  (void)printf("fails/trans:            %.3f ns/call\n", old);
+  (void)printf("EXFC_FAILS/EXFC_TRANS:  %.3f ns/call\n", new);
+
+  return 0;
+}
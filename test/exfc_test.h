@@ -0,0 +1,72 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfc_test.h
+ * @brief Minimal checks for the programs under test/. Every test_*.c is one
+ *        program; "make check" builds and runs them all, and fails on the
+ *        first one exiting non-zero.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#ifndef EXFC_TEST_H
+# define EXFC_TEST_H
+
+# include <stdio.h>
+
+# include "exfc.h"
+
+static int _exfc_test_failed = 0;
+
+/**
+ * @brief Report COND once it does not hold, and go on.
+ */
+# define EXFC_TEST(cond)                                                     \
+  do                                                                        \
+    {                                                                       \
+      if (!(cond))                                                          \
+        {                                                                   \
+          (void)fprintf(stderr, "%s:%d: FAILED: %s\n", __FILE__, __LINE__,  \
+                        #cond);                                             \
+          _exfc_test_failed += 1;                                           \
+        }                                                                   \
+    }                                                                       \
+  while (0)
+
+/**
+ * @brief Report the result of the whole program.
+ * @return 0 once every EXFC_TEST held, 1 otherwise.
+ */
+# define EXFC_TEST_END()                                                     \
+  ((void)fprintf(stderr, "%s: %s\n", __FILE__,                              \
+                 (_exfc_test_failed == 0) ? "passed" : "FAILED"),            \
+   (_exfc_test_failed != 0))
+
+/**
+ * @brief Empty every slot of $_excep_arr, as the registry expects before
+ *        its first use.
+ */
+static inline void
+exfc_test_reset_registry()
+{
+  for (register int i = 0; i < _excep_arr_len; i ++)
+    {
+      _excep_arr[i] = excep_null;
+    }
+}
+
+#endif /* NO EXFC_TEST_H */
@@ -0,0 +1,96 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_block.c
+ * @brief ID blocks are packed first-fit, owned by their module, and once
+ *        released take their exceptions & handlers along and leave the gap
+ *        for the next reservation to reuse.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include "exfc_block.h"
+#include "exfc_test.h"
+
+static exfc_policy
+ignore(const _excep_t *except, const char *file, long int line,
+       const char *function, void *data)
+{
+  (void)except;
+  (void)file;
+  (void)line;
+  (void)function;
+  (void)data;
+  return EXFC_POLICY_IGNORE;
+}
+
+int
+main()
+{
+  exfc_test_reset_registry();
+
+  exfc_block a;
+  exfc_block b;
+  exfc_block c;
+  exfc_block d;
+
+  EXFC_TEST(exfc_block_reserve("liba", 16, &a) == NORMAL);
+  EXFC_TEST(exfc_block_reserve("libb", 8, &b) == NORMAL);
+  EXFC_TEST(exfc_block_reserve("libc", 4, &c) == NORMAL);
+  EXFC_TEST(a._base == EXFC_BLOCK_ID_BASE && a._count == 16);
+  EXFC_TEST(b._base == a._base + 16 && c._base == b._base + 8);
+
+  /* One block per module. */
+  EXFC_TEST(exfc_block_reserve("liba", 2, &d) == DUPLICATED);
+  EXFC_TEST(d._base == a._base && d._count == 16);
+
+  /* Too large for what is left. */
+  EXFC_TEST(exfc_block_reserve("huge", EXFC_BLOCK_ID_END, &d)
+            == CONDITIONAL);
+  EXFC_TEST(exfc_block_reserve("zero", 0, &d) == FAILED);
+
+  EXFC_TEST(exfc_block_addexcep(&b, "BFooException", "d", 0) >= 0);
+  EXFC_TEST(exfc_block_addexcep(&b, "BBarException", "d", 7) >= 0);
+  EXFC_TEST(exfc_block_addexcep(&b, "BBadException", "d", 8)
+            == CONDITIONAL);
+  EXFC_TEST(exfc_getindex_byid(exfc_block_id(&b, 7)) >= 0);
+  EXFC_TEST(exfc_handler_set(exfc_block_id(&b, 0), ignore, NULL) == NORMAL);
+
+  EXFC_TEST(exfc_block_owner(b._base + 3, &d) == NORMAL
+            && d._base == b._base);
+  EXFC_TEST(exfc_block_owner(c._base + 4, &d) == MISSING);
+  EXFC_TEST(exfc_block_find("libc", &d) == NORMAL && d._base == c._base);
+
+  /* Release takes the exceptions & handlers of the block along. */
+  EXFC_TEST(exfc_block_release(&b) == 2);
+  EXFC_TEST(exfc_getindex_byname("BFooException") == MISSING);
+  EXFC_TEST(exfc_getindex_byid(exfc_block_id(&b, 7)) == MISSING);
+  EXFC_TEST(_exfc_handlers[b._base] == NULL);
+  EXFC_TEST(exfc_block_find("libb", &d) == MISSING);
+  EXFC_TEST(exfc_block_owner(b._base, &d) == MISSING);
+  EXFC_TEST(exfc_block_release(&b) == MISSING);
+  EXFC_TEST(exfc_block_addexcep(&b, "BFooException", "d", 0) == MISSING);
+
+  /* The gap is reused first-fit; what does not fit goes past the end. */
+  EXFC_TEST(exfc_block_reserve("libe", 6, &d) == NORMAL
+            && d._base == b._base);
+  EXFC_TEST(exfc_block_reserve("libf", 4, &d) == NORMAL
+            && d._base == c._base + 4);
+  EXFC_TEST(exfc_block_reserve("libg", 2, &d) == NORMAL
+            && d._base == b._base + 6);
+
+  return EXFC_TEST_END();
+}
@@ -0,0 +1,134 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_chain.c
+ * @brief Cause chains: rethrowing keeps the causes newest first, a plain
+ *        THROW drops them, and the pool stops at EXFC_CHAIN_MAX, counting
+ *        what it drops, until cleared.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include "exfc_chain.h"
+#include "exfc_test.h"
+
+static _excep_t bound = {"OutOfBoundException", "Accessed out of bound.",
+                         OutOfBoundException};
+static _excep_t internal = {"InternalException", "Internal error of ExFC.",
+                            InternalException};
+static _excep_t arith = {"ArithmeticException",
+                         "Arithmetic operation faulted.",
+                         ArithmeticException};
+
+/* Throw $bound, rethrow it as $internal, that as $arith. */
+static void
+rethrow_twice()
+{
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      exfc_catch d;
+      if (EXFC_TRY(d))
+        {
+          (void)THROW(&bound, "test_chain.c", 1, "rethrow_twice", NULL);
+          exfc_catch_pop(&d);
+        }
+      else
+        {
+          (void)THROW_WITH_CAUSE(&internal, d);
+        }
+      exfc_catch_pop(&c);
+    }
+  else
+    {
+      (void)THROW_WITH_CAUSE(&arith, c);
+    }
+}
+
+int
+main()
+{
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      rethrow_twice();
+      exfc_catch_pop(&c);
+      EXFC_TEST(!"rethrow_twice did not throw");
+    }
+  else
+    {
+      EXFC_TEST(c._except._id == ArithmeticException);
+
+      const exfc_cause *cause = c._cause;
+      EXFC_TEST(cause != NULL && cause->_except._id == InternalException);
+      cause = (cause == NULL ? NULL : cause->_next);
+      EXFC_TEST(cause != NULL && cause->_except._id == OutOfBoundException
+                && cause->_line == 1);
+      EXFC_TEST(cause != NULL && cause->_next == NULL);
+    }
+
+  /* A THROW without cause starts over. */
+  if (EXFC_TRY(c))
+    {
+      (void)THROW(&bound, "test_chain.c", 2, "main", NULL);
+      exfc_catch_pop(&c);
+    }
+  else
+    {
+      EXFC_TEST(c._cause == NULL);
+      EXFC_TEST(exfc_chain_head() == NULL);
+    }
+
+  /* The pool keeps EXFC_CHAIN_MAX causes and counts the rest. */
+  exfc_chain_clear();
+  for (register int i = 0; i < EXFC_CHAIN_MAX; i ++)
+    {
+      EXFC_TEST(_exfc_chain_push_site(&bound, "test_chain.c", i, "main")
+                == NORMAL);
+    }
+  for (register int i = 0; i < 5; i ++)
+    {
+      EXFC_TEST(_exfc_chain_push_site(&bound, "test_chain.c", -1, "main")
+                == CONDITIONAL);
+    }
+  EXFC_TEST(exfc_chain_dropped() == 5);
+  EXFC_TEST(exfc_chain_head() != NULL
+            && exfc_chain_head()->_line == EXFC_CHAIN_MAX - 1);
+
+  unsigned int len = 0;
+  for (const exfc_cause *cause = exfc_chain_head(); cause != NULL;
+       cause = cause->_next)
+    {
+      len += 1;
+    }
+  EXFC_TEST(len == EXFC_CHAIN_MAX);
+
+  /* Clearing gives every node back. */
+  exfc_chain_clear();
+  EXFC_TEST(exfc_chain_head() == NULL && exfc_chain_dropped() == 0);
+  for (register int i = 0; i < EXFC_CHAIN_MAX; i ++)
+    {
+      EXFC_TEST(_exfc_chain_push_site(&bound, "test_chain.c", i, "main")
+                == NORMAL);
+    }
+  EXFC_TEST(_exfc_chain_push_site(&bound, "test_chain.c", -1, "main")
+            == CONDITIONAL);
+  exfc_chain_clear();
+
+  return EXFC_TEST_END();
+}
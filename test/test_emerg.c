@@ -0,0 +1,138 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_emerg.c
+ * @brief OutOfMemoryException gives the heap reserve back and is reported,
+ *        causes included, without a single allocation.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "exfc_chain.h"
+#include "exfc_emerg.h"
+#include "exfc_handler.h"
+#include "exfc_test.h"
+
+/* Allocations are counted while $counting, through glibc's own entry
+   points this program interposes. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *p, size_t size);
+
+static volatile bool counting = false;
+static volatile int allocated = 0;
+
+void *
+malloc(size_t size)
+{
+  if (counting)
+    {
+      allocated += 1;
+    }
+  return __libc_malloc(size);
+}
+
+void *
+calloc(size_t n, size_t size)
+{
+  if (counting)
+    {
+      allocated += 1;
+    }
+  return __libc_calloc(n, size);
+}
+
+void *
+realloc(void *p, size_t size)
+{
+  if (counting)
+    {
+      allocated += 1;
+    }
+  return __libc_realloc(p, size);
+}
+
+/* Report, then go on. */
+static exfc_policy
+log_only(const _excep_t *except, const char *file, long int line,
+         const char *function, void *data)
+{
+  (void)except;
+  (void)file;
+  (void)line;
+  (void)function;
+  (void)data;
+  return EXFC_POLICY_LOG;
+}
+
+static _excep_t bound = {"OutOfBoundException", "Accessed out of bound.",
+                         OutOfBoundException};
+
+int
+main()
+{
+  EXFC_TEST(exfc_emerg_init(4096) == NORMAL);
+  EXFC_TEST(exfc_emerg_init(4096) == DUPLICATED);
+  EXFC_TEST(exfc_emerg_reserved());
+  EXFC_TEST(exfc_handler_set(OutOfMemoryException, log_only, NULL)
+            == NORMAL);
+
+  /* Catch the report through a pipe in place of stderr. */
+  int fd[2];
+  EXFC_TEST(pipe(fd) == 0);
+  const int err = dup(STDERR_FILENO);
+  (void)dup2(fd[1], STDERR_FILENO);
+
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      (void)THROW(&bound, "test_emerg.c", 1, "main", NULL);
+      exfc_catch_pop(&c);
+    }
+  else
+    {
+      counting = true;
+      (void)exfc_rethrow(&exfc_emerg_oom, &c, "test_emerg.c", 2, "main",
+                         NULL);
+      counting = false;
+    }
+
+  (void)dup2(err, STDERR_FILENO);
+  (void)close(fd[1]);
+
+  char report[1024];
+  const ssize_t n = read(fd[0], report, sizeof(report) - 1);
+  report[(n < 0) ? 0 : n] = '\0';
+  (void)close(fd[0]);
+
+  EXFC_TEST(allocated == 0);
+  EXFC_TEST(!exfc_emerg_reserved());
+  EXFC_TEST(strcmp(report,
+                   "Threw the OutOfMemoryException:\n"
+                   "\tat test_emerg.c:2, func main\n"
+                   "\"Ran out of memory.\"\n"
+                   "Caused by the OutOfBoundException:\n"
+                   "\tat test_emerg.c:1, func main\n"
+                   "\"Accessed out of bound.\"\n") == 0);
+
+  return EXFC_TEST_END();
+}
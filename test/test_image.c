@@ -0,0 +1,148 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file test_image.c
+ * @brief exfc_image: save, load & look up; truncated and corrupted images
+ *        are rejected by exfc_image_load.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "exfc_image.h"
+#include "exfc_test.h"
+
+static char image[65536];
+static size_t image_len = 0;
+
+static void
+read_image(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+
+  image_len = (f == NULL) ? 0 : fread(image, 1, sizeof(image), f);
+  if (f != NULL)
+    {
+      (void)fclose(f);
+    }
+}
+
+/* Load a copy of the saved image, LEN bytes of it, with the 32-bit word
+   at OFF replaced by VAL (OFF < 0 leaves it as it is). */
+static int
+load_altered(const char *path, size_t len, long off, uint32_t val)
+{
+  char copy[sizeof(image)];
+  (void)memcpy(copy, image, image_len);
+  if (off >= 0)
+    {
+      (void)memcpy(&copy[off], &val, sizeof(val));
+    }
+
+  FILE *f = fopen(path, "wb");
+  if (f == NULL || fwrite(copy, 1, len, f) != len)
+    {
+      return ABNORMAL;
+    }
+  (void)fclose(f);
+
+  exfc_image img;
+  const int rtn = exfc_image_load(path, &img);
+  if (rtn == NORMAL)
+    {
+      exfc_image_unload(&img);
+    }
+  return rtn;
+}
+
+int
+main()
+{
+  char dir[] = "/tmp/exfc_test_image.XXXXXX";
+  EXFC_TEST(mkdtemp(dir) != NULL);
+
+  char path[sizeof(dir) + 16];
+  char bad[sizeof(dir) + 16];
+  (void)snprintf(path, sizeof(path), "%s/reg.img", dir);
+  (void)snprintf(bad, sizeof(bad), "%s/bad.img", dir);
+
+  exfc_test_reset_registry();
+  EXFC_TEST(exfc_addexcep("FirstException", "The first one.", 300) >= 0);
+  EXFC_TEST(exfc_addexcep("SecondException", "The second one.", 100) >= 0);
+  EXFC_TEST(exfc_addexcep("ThirdException", "The third one.", 200) >= 0);
+
+  /* Round trip */
+  EXFC_TEST(exfc_image_save(path) == NORMAL);
+
+  exfc_image img;
+  EXFC_TEST(exfc_image_load(path, &img) == NORMAL);
+  EXFC_TEST(img._hdr->_count == 3);
+
+  const int byname = exfc_image_getindex_byname(&img, "SecondException");
+  EXFC_TEST(byname >= 0);
+  EXFC_TEST(exfc_image_getindex_byid(&img, 100) == byname);
+  EXFC_TEST(strcmp(exfc_image_get(&img, byname)._description,
+                   "The second one.") == 0);
+  EXFC_TEST(exfc_image_get(&img, exfc_image_getindex_byid(&img, 300))._id
+            == 300);
+  EXFC_TEST(exfc_image_getindex_byname(&img, "NoSuchException") == MISSING);
+  EXFC_TEST(exfc_image_getindex_byid(&img, 150) == MISSING);
+  exfc_image_unload(&img);
+
+  /* Damaged copies */
+  read_image(path);
+  EXFC_TEST(image_len > sizeof(exfc_image_hdr));
+  const exfc_image_hdr *hdr = (const exfc_image_hdr *)image;
+
+  EXFC_TEST(load_altered(bad, image_len, -1, 0) == NORMAL);
+  EXFC_TEST(load_altered(bad, image_len - 1, -1, 0) == CONDITIONAL);
+  EXFC_TEST(load_altered(bad, sizeof(exfc_image_hdr) / 2, -1, 0)
+            == CONDITIONAL);
+  EXFC_TEST(load_altered(bad, image_len, 0, 0) == CONDITIONAL);
+
+  /* A bucket naming an entry past $_count */
+  long b = (long)hdr->_bucket_off;
+  while (*(const uint32_t *)&image[b] == 0)
+    {
+      b += sizeof(uint32_t);
+    }
+  EXFC_TEST(load_altered(bad, image_len, b, hdr->_count + 7) == CONDITIONAL);
+
+  /* A name running past the string table */
+  const long ent = (long)hdr->_ent_off;
+  EXFC_TEST(load_altered(bad, image_len,
+                         ent + offsetof(exfc_image_ent, _name_off),
+                         hdr->_str_len + 100) == CONDITIONAL);
+  EXFC_TEST(load_altered(bad, image_len,
+                         ent + offsetof(exfc_image_ent, _name_len),
+                         hdr->_str_len) == CONDITIONAL);
+
+  /* An ID index pointing past the entries */
+  EXFC_TEST(load_altered(bad, image_len, (long)hdr->_byid_off, 99)
+            == CONDITIONAL);
+
+  (void)unlink(path);
+  (void)unlink(bad);
+  (void)rmdir(dir);
+
+  return EXFC_TEST_END();
+}
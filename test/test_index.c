@@ -0,0 +1,98 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_index.c
+ * @brief Prefix & range queries follow exfc_addexcep and
+ *        exfc_removeexcep_by*, in name & ID order, and stop at the
+ *        capacity given.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <string.h>
+
+#include "exfc_index.h"
+#include "exfc_test.h"
+
+/* Whether OUT[0 .. N - 1] holds exactly IDS, in order. */
+static bool
+ids_are(const exfc_index_ent *out, int n, const int *ids, int len)
+{
+  if (n != len)
+    {
+      return false;
+    }
+
+  for (register int i = 0; i < n; i ++)
+    {
+      if (out[i]._id != ids[i])
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+int
+main()
+{
+  exfc_test_reset_registry();
+
+  EXFC_TEST(exfc_addexcep("NetTimeoutException", "d", 530) >= 0);
+  EXFC_TEST(exfc_addexcep("DiskFullException", "d", 510) >= 0);
+  EXFC_TEST(exfc_addexcep("NetResetException", "d", 520) >= 0);
+  EXFC_TEST(exfc_addexcep("NetException", "d", 500) >= 0);
+  EXFC_TEST(exfc_addexcep("DiskException", "d", 540) >= 0);
+
+  exfc_index_ent out[8];
+
+  /* Name order within the prefix. */
+  int n = exfc_index_prefix("Net", out, 8);
+  EXFC_TEST(ids_are(out, n, (const int[]){500, 520, 530}, 3));
+  EXFC_TEST(n > 0 && strcmp(out[0]._name, "NetException") == 0
+            && out[0]._len == strlen("NetException"));
+
+  EXFC_TEST(exfc_index_prefix("Disk", out, 8) == 2);
+  EXFC_TEST(exfc_index_prefix("Nope", out, 8) == 0);
+  EXFC_TEST(exfc_index_prefix("", out, 8) == 5);
+  EXFC_TEST(exfc_index_prefix("NetException", out, 8) == 1);
+  EXFC_TEST(exfc_index_prefix("NetExceptionX", out, 8) == 0);
+
+  /* ID order within the range, both ends included. */
+  n = exfc_index_range(510, 530, out, 8);
+  EXFC_TEST(ids_are(out, n, (const int[]){510, 520, 530}, 3));
+  EXFC_TEST(exfc_index_range(531, 539, out, 8) == 0);
+  EXFC_TEST(exfc_index_range(530, 510, out, 8) == 0);
+
+  /* At most $max. */
+  n = exfc_index_range(0, 1000, out, 2);
+  EXFC_TEST(ids_are(out, n, (const int[]){500, 510}, 2));
+  n = exfc_index_prefix("Net", out, 1);
+  EXFC_TEST(ids_are(out, n, (const int[]){500}, 1));
+
+  /* Removals leave both indexes. */
+  EXFC_TEST(exfc_removeexcep_byid(520) >= 0);
+  EXFC_TEST(exfc_removeexcep_byname("DiskFullException") >= 0);
+  n = exfc_index_prefix("Net", out, 8);
+  EXFC_TEST(ids_are(out, n, (const int[]){500, 530}, 2));
+  n = exfc_index_range(0, 1000, out, 8);
+  EXFC_TEST(ids_are(out, n, (const int[]){500, 530, 540}, 3));
+
+  EXFC_TEST(exfc_index_prefix(NULL, out, 8) == FAILED);
+  EXFC_TEST(exfc_index_range(0, 1, NULL, 8) == FAILED);
+
+  return EXFC_TEST_END();
+}
@@ -0,0 +1,70 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file test_registry_n.c
+ * @brief Length-carrying registry calls: lengths that are not strlen(name)
+ *        are rejected, and matching ones behave as the plain calls.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include "exfc_handler.h"
+#include "exfc_test.h"
+
+static exfc_policy
+ignore(const _excep_t *except, const char *file, long int line,
+       const char *function, void *data)
+{
+  (void)except;
+  (void)file;
+  (void)line;
+  (void)function;
+  (void)data;
+  return EXFC_POLICY_IGNORE;
+}
+
+int
+main()
+{
+  /* Overflows throw BufferOverflowException; keep going past it. */
+  (void)exfc_handler_set(BufferOverflowException, ignore, NULL);
+
+  exfc_test_reset_registry();
+
+  /* Too short, too long, and a '\0' inside of $len */
+  EXFC_TEST(exfc_addexcep_n("FooException", 3, "d", 500) == FAILED);
+  EXFC_TEST(exfc_addexcep_n("Foo", 5, "d", 500) == FAILED);
+  EXFC_TEST(exfc_addexcep_n("Foo\0Bar", 7, "d", 500) == FAILED);
+  EXFC_TEST(exfc_getindex_byid(500) == MISSING);
+
+  EXFC_TEST(exfc_addexcep_n("FooException", 12, "d", 500) >= 0);
+  const int idx = exfc_getindex_byname("FooException");
+  EXFC_TEST(idx >= 0);
+  EXFC_TEST(exfc_getindex_byname_n("FooException", 12) == idx);
+  EXFC_TEST(exfc_getindex_byname_n("FooException", 3) == FAILED);
+  EXFC_TEST(exfc_getindex_byname_n("FooException", EXCEP_BUFF_MAX + 1)
+            == FAILED);
+  EXFC_TEST(exfc_addexcep_n("FooException", 12, "d", 501) == DUPLICATED);
+
+  EXFC_TEST(exfc_removeexcep_byname_n("FooException", 3) == FAILED);
+  EXFC_TEST(exfc_getindex_byid(500) == idx);
+  EXFC_TEST(exfc_removeexcep_byname_n("FooException", 12) == idx);
+  EXFC_TEST(exfc_getindex_byid(500) == MISSING);
+  EXFC_TEST(exfc_getindex_byname("FooException") == MISSING);
+
+  return EXFC_TEST_END();
+}
@@ -0,0 +1,137 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file test_shm.c
+ * @brief exfc_shm: attaching from a second process, reuse of string space,
+ *        and readers surviving a writer that died in its write section.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "exfc_shm.h"
+#include "exfc_test.h"
+
+#define TEST_SHM_NAME "/exfc_test_shm"
+
+/* Exit status of a child running FN. */
+static int
+run_child(int (*fn)())
+{
+  const pid_t pid = fork();
+
+  if (pid == 0)
+    {
+      _exit(fn());
+    }
+
+  int status = 0;
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+      return -1;
+    }
+  return WEXITSTATUS(status);
+}
+
+static int
+child_add()
+{
+  /* Map it anew, as an unrelated process would. */
+  (void)exfc_shm_detach();
+  if (exfc_shm_attach(TEST_SHM_NAME) != NORMAL)
+    {
+      return 1;
+    }
+  return ((exfc_shm_addexcep("ChildException", "Added by the child.", 901)
+           >= 0) ? 0 : 2);
+}
+
+/* Die holding the lock, halfway through a write section. */
+static int
+child_die_writing()
+{
+  const int fd = shm_open(TEST_SHM_NAME, O_RDWR, 0);
+  if (fd < 0)
+    {
+      return 1;
+    }
+
+  exfc_shm_region *r = mmap(NULL, sizeof(exfc_shm_region),
+                            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (r == MAP_FAILED)
+    {
+      return 1;
+    }
+
+  (void)pthread_mutex_lock(&r->_lock);
+  __atomic_add_fetch(&r->_seq, 1u, __ATOMIC_RELEASE);
+
+  return 0;
+}
+
+int
+main()
+{
+  (void)exfc_shm_unlink(TEST_SHM_NAME);
+  EXFC_TEST(exfc_shm_attach(TEST_SHM_NAME) == NORMAL);
+
+  /* A second process sees the same registry, both ways. */
+  EXFC_TEST(exfc_shm_addexcep("ParentException", "Added by the parent.",
+                              900) >= 0);
+  EXFC_TEST(run_child(child_add) == 0);
+
+  const int idx = exfc_shm_getindex_byname("ChildException");
+  EXFC_TEST(idx >= 0);
+  EXFC_TEST(exfc_shm_getindex_byid(901) == idx);
+  EXFC_TEST(strcmp(exfc_shm_get(idx)._description, "Added by the child.")
+            == 0);
+  EXFC_TEST(exfc_shm_addexcep("ChildException", "Again.", 902)
+            == DUPLICATED);
+
+  /* Far more adds than the string space holds at once. */
+  int cycles = 0;
+  for (; cycles < 20000; cycles ++)
+    {
+      if (exfc_shm_addexcep("CycledException",
+                            "Added & removed over and over again.", 903) < 0
+          || exfc_shm_removeexcep_byid(903) < 0)
+        {
+          break;
+        }
+    }
+  EXFC_TEST(cycles == 20000);
+  EXFC_TEST(exfc_shm_getindex_byid(900) >= 0);
+
+  /* Readers must not wait forever on a dead writer. */
+  EXFC_TEST(run_child(child_die_writing) == 0);
+  EXFC_TEST(exfc_shm_getindex_byid(900) >= 0);
+  EXFC_TEST(exfc_shm_addexcep("AfterException", "After the death.", 904)
+            >= 0);
+
+  (void)exfc_shm_detach();
+  (void)exfc_shm_unlink(TEST_SHM_NAME);
+
+  return EXFC_TEST_END();
+}
@@ -0,0 +1,89 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_site.c
+ * @brief Per-site caches of THROW_BYID & THROW_BYNAME follow the registry:
+ *        after exfc_removeexcep_byid, or a new exception in the same slot,
+ *        the same site throws what is registered now.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include "exfc_catch.h"
+#include "exfc_site.h"
+#include "exfc_test.h"
+
+/* ID of what the single THROW_BYID site below threw. */
+static int
+throw_byid(int id)
+{
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      (void)THROW_BYID(id);
+      exfc_catch_pop(&c);
+      return -1;
+    }
+  return c._except._id;
+}
+
+static int
+throw_byname(const char *name)
+{
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      (void)THROW_BYNAME(name);
+      exfc_catch_pop(&c);
+      return -1;
+    }
+  return c._except._id;
+}
+
+int
+main()
+{
+  exfc_test_reset_registry();
+
+  EXFC_TEST(exfc_addexcep("FooException", "d", 600) >= 0);
+  EXFC_TEST(throw_byid(600) == 600);
+  /* Now from the cache. */
+  EXFC_TEST(throw_byid(600) == 600);
+
+  /* Removed: the cached slot must not be thrown any more. */
+  const unsigned int gen = _exfc_registry_gen;
+  EXFC_TEST(exfc_removeexcep_byid(600) >= 0);
+  EXFC_TEST(_exfc_registry_gen != gen);
+  EXFC_TEST(throw_byid(600) == UnknownException);
+
+  /* Another exception in the slot the site had cached. */
+  EXFC_TEST(exfc_addexcep("BarException", "d", 601) >= 0);
+  EXFC_TEST(throw_byid(600) == UnknownException);
+  EXFC_TEST(throw_byid(601) == 601);
+  EXFC_TEST(exfc_addexcep("FooException", "d", 600) >= 0);
+  EXFC_TEST(throw_byid(600) == 600);
+
+  /* By name: same name under a new ID. */
+  EXFC_TEST(throw_byname("BarException") == 601);
+  EXFC_TEST(throw_byname("BarException") == 601);
+  EXFC_TEST(exfc_removeexcep_byid(601) >= 0);
+  EXFC_TEST(throw_byname("BarException") == UnknownException);
+  EXFC_TEST(exfc_addexcep("BarException", "d", 602) >= 0);
+  EXFC_TEST(throw_byname("BarException") == 602);
+  EXFC_TEST(throw_byname("FooException") == 600);
+
+  return EXFC_TEST_END();
+}
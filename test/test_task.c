@@ -0,0 +1,110 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ * @file test_task.c
+ * @brief Tasks run on a worker thread: a thrown payload reaches the catch
+ *        context of the joiner, and a payload attached before a normal
+ *        return is dropped.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#define _DEFAULT_SOURCE 1
+
+#include <pthread.h>
+#include <string.h>
+
+#include "exfc_task.h"
+#include "exfc_test.h"
+
+static _excep_t oom = {"OutOfMemoryException", "Memory was exhausted.",
+                       OutOfMemoryException};
+
+static int
+throws(void *arg)
+{
+  (void)arg;
+  (void)exfc_task_payload("disk full", 10);
+  (void)THROW(&oom, "test_task.c", 1, "throws", NULL);
+  return 0;
+}
+
+static int
+returns(void *arg)
+{
+  (void)arg;
+  (void)exfc_task_payload("stale", 6);
+  return 42;
+}
+
+static void *
+worker(void *arg)
+{
+  (void)exfc_task_run(arg);
+  return NULL;
+}
+
+static void
+run(exfc_task *task, exfc_task_fn fn)
+{
+  pthread_t t;
+
+  (void)exfc_task_init(task, fn, NULL);
+  (void)pthread_create(&t, NULL, worker, task);
+  (void)pthread_join(t, NULL);
+}
+
+int
+main()
+{
+  exfc_task task;
+
+  run(&task, returns);
+  EXFC_TEST(exfc_task_wait(&task) == EXFC_TASK_DONE);
+  EXFC_TEST(task._payload_len == 0);
+  EXFC_TEST(exfc_task_join(&task) == 42);
+
+  run(&task, throws);
+  EXFC_TEST(exfc_task_wait(&task) == EXFC_TASK_THROWN);
+
+  exfc_catch c;
+  if (EXFC_TRY(c))
+    {
+      (void)exfc_task_join(&task);
+      exfc_catch_pop(&c);
+      EXFC_TEST(!"exfc_task_join did not throw");
+    }
+  else
+    {
+      EXFC_TEST(c._except._id == OutOfMemoryException);
+      EXFC_TEST(c._payload_len == 10);
+      EXFC_TEST(c._payload != NULL
+                && memcmp(c._payload, "disk full", 10) == 0);
+    }
+
+  /* A plain THROW afterwards carries none. */
+  if (EXFC_TRY(c))
+    {
+      (void)THROW(&oom, "test_task.c", 2, "main", NULL);
+      exfc_catch_pop(&c);
+    }
+  else
+    {
+      EXFC_TEST(c._payload == NULL && c._payload_len == 0);
+    }
+
+  return EXFC_TEST_END();
+}
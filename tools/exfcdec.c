@@ -0,0 +1,328 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfcdec.c
+ * @brief Binary exception log decoder. Prints a log written by
+ *        exfc_binlog_open in the text format of EXCEPT_FMT, prefixed by the
+ *        time of every event.
+ *
+ *        Usage: exfcdec LOG
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "exfc_binlog_fmt.h"
+
+typedef struct _exfcdec_str_S
+{
+  char *_s;
+  uint64_t _len;
+} exfcdec_str;
+
+typedef struct _exfcdec_excep_S
+{
+  long int _id;
+  exfcdec_str _name;
+  exfcdec_str _description;
+} exfcdec_excep;
+
+typedef struct _exfcdec_site_S
+{
+  long int _line;
+  exfcdec_str _file;
+  exfcdec_str _function;
+} exfcdec_site;
+
+static FILE *in = NULL;
+static const char *in_path = NULL;
+
+static exfcdec_excep *exceps = NULL;
+static size_t exceps_len = 0;
+
+/* $exceps by ID, open addressing; index + 1, 0 for empty. */
+static size_t *excep_by_id = NULL;
+static size_t excep_by_id_cap = 0;
+static size_t excep_by_id_len = 0;
+
+/* Indexed by site ID. */
+static exfcdec_site *sites = NULL;
+static size_t sites_cap = 0;
+
+static void
+die(const char *msg)
+{
+  (void)fprintf(stderr, "exfcdec: %s: %s at offset %ld\n", in_path, msg,
+                ftell(in));
+  exit(1);
+}
+
+static void *
+grow(void *p, size_t size)
+{
+  void *rtn = realloc(p, size);
+
+  if (rtn == NULL)
+    {
+      die("out of memory");
+    }
+  return rtn;
+}
+
+static uint64_t
+get_varint()
+{
+  uint64_t v = 0;
+
+  for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      const int c = fgetc(in);
+
+      if (c == EOF)
+        {
+          die("truncated varint");
+        }
+
+      v |= (uint64_t)(c & 0x7F) << shift;
+
+      if (!(c & 0x80))
+        {
+          return v;
+        }
+    }
+  die("varint too long");
+  return 0;
+}
+
+static long int
+unzigzag(uint64_t v)
+{
+  return (long int)((v >> 1) ^ (~(v & 1) + 1));
+}
+
+static void
+get_bytes(void *p, uint64_t len)
+{
+  if (len > 0 && fread(p, 1, (size_t)len, in) != len)
+    {
+      die("truncated record");
+    }
+}
+
+static exfcdec_str
+get_str()
+{
+  exfcdec_str rtn;
+
+  rtn._len = get_varint();
+  if (rtn._len > EXCEP_BUFF_MAX)
+    {
+      die("string too long");
+    }
+
+  rtn._s = grow(NULL, (size_t)rtn._len + 1);
+  get_bytes(rtn._s, rtn._len);
+  rtn._s[rtn._len] = '\0';
+
+  return rtn;
+}
+
+static size_t
+excep_slot(const size_t *table, size_t cap, long int id)
+{
+  size_t b = ((size_t)id * 2654435761u) & (cap - 1);
+
+  while (table[b] != 0 && exceps[table[b] - 1]._id != id)
+    {
+      b = (b + 1) & (cap - 1);
+    }
+  return b;
+}
+
+/* Latest description of $id, or NULL. */
+static exfcdec_excep *
+find_excep(long int id)
+{
+  if (excep_by_id_cap == 0)
+    {
+      return NULL;
+    }
+
+  const size_t i = excep_by_id[excep_slot(excep_by_id, excep_by_id_cap, id)];
+  return ((i == 0) ? NULL : &exceps[i - 1]);
+}
+
+/* Make $exceps[IDX] the description of its ID. */
+static void
+index_excep(size_t idx)
+{
+  /* Keep the load factor at most 1/2. */
+  if ((excep_by_id_len + 1) * 2 > excep_by_id_cap)
+    {
+      const size_t cap = (excep_by_id_cap == 0) ? 64 : excep_by_id_cap * 2;
+      size_t *table = calloc(cap, sizeof(size_t));
+
+      if (table == NULL)
+        {
+          die("out of memory");
+        }
+
+      for (size_t b = 0; b < excep_by_id_cap; b ++)
+        {
+          if (excep_by_id[b] != 0)
+            {
+              const long int id = exceps[excep_by_id[b] - 1]._id;
+              table[excep_slot(table, cap, id)] = excep_by_id[b];
+            }
+        }
+
+      free(excep_by_id);
+      excep_by_id = table;
+      excep_by_id_cap = cap;
+    }
+
+  const size_t b = excep_slot(excep_by_id, excep_by_id_cap, exceps[idx]._id);
+  if (excep_by_id[b] == 0)
+    {
+      excep_by_id_len += 1;
+    }
+  excep_by_id[b] = idx + 1;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 2)
+    {
+      (void)fprintf(stderr, "usage: %s LOG\n", argv[0]);
+      return 2;
+    }
+
+  in_path = argv[1];
+  in = fopen(in_path, "rb");
+  if (in == NULL)
+    {
+      perror(in_path);
+      return 1;
+    }
+
+  char magic[EXFC_BINLOG_MAGIC_LEN];
+  if (fread(magic, 1, sizeof(magic), in) != sizeof(magic)
+      || memcmp(magic, EXFC_BINLOG_MAGIC, sizeof(magic)) != 0)
+    {
+      die("not an ExFC binary log");
+    }
+
+  uint64_t now = get_varint();
+
+  int c;
+  while ((c = fgetc(in)) != EOF)
+    {
+      switch (c)
+        {
+        case EXFC_BINLOG_TAG_EXCEP:
+          {
+            exceps = grow(exceps, sizeof(exfcdec_excep) * (exceps_len + 1));
+            exceps[exceps_len]._id = unzigzag(get_varint());
+            exceps[exceps_len]._name = get_str();
+            exceps[exceps_len]._description = get_str();
+            index_excep(exceps_len);
+            exceps_len += 1;
+            break;
+          }
+        case EXFC_BINLOG_TAG_SITE:
+          {
+            const uint64_t id = get_varint();
+            if (id == 0 || id > EXFC_BINLOG_DICT_MAX)
+              {
+                die("invalid site");
+              }
+
+            if (id >= sites_cap)
+              {
+                const size_t cap = (size_t)id + 1;
+                sites = grow(sites, sizeof(exfcdec_site) * cap);
+                (void)memset(&sites[sites_cap], 0,
+                             sizeof(exfcdec_site) * (cap - sites_cap));
+                sites_cap = cap;
+              }
+
+            sites[id]._line = unzigzag(get_varint());
+            sites[id]._file = get_str();
+            sites[id]._function = get_str();
+            break;
+          }
+        case EXFC_BINLOG_TAG_EVENT:
+          {
+            const long int id = unzigzag(get_varint());
+            const uint64_t site = get_varint();
+            now += get_varint();
+
+            const uint64_t len = get_varint();
+            if (len > EXFC_BINLOG_ARG_MAX)
+              {
+                die("arguments too long");
+              }
+
+            unsigned char arg[EXFC_BINLOG_ARG_MAX];
+            get_bytes(arg, len);
+
+            const exfcdec_excep *e = find_excep(id);
+            const exfcdec_site *s = (site > 0 && site < sites_cap
+                                     && sites[site]._file._s != NULL)
+                                    ? &sites[site] : NULL;
+
+            (void)printf("[%" PRIu64 ".%06" PRIu64 "] ", now / 1000000u,
+                         now % 1000000u);
+
+            if (s == NULL)
+              {
+                (void)printf(DEF_EXCEPT_FMT,
+                             (e == NULL) ? "(unknown)" : e->_name._s);
+              }
+            else
+              {
+                (void)printf(EXCEPT_FMT,
+                             (e == NULL) ? "(unknown)" : e->_name._s,
+                             s->_file._s, s->_line, s->_function._s,
+                             (e == NULL) ? "" : e->_description._s);
+              }
+
+            if (len > 0)
+              {
+                (void)printf("\targs:");
+                for (uint64_t i = 0; i < len; i ++)
+                  {
+                    (void)printf(" %02x", arg[i]);
+                  }
+                (void)printf("\n");
+              }
+            break;
+          }
+        default:
+          die("unknown record");
+        }
+    }
+
+  (void)fclose(in);
+
+  return 0;
+}
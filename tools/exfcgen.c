@@ -0,0 +1,795 @@
+/**
+ *     This file is part of project <https://github.com/Wilhelm-Lee/ExFC>
+ *     Copyright (C) 2022 - 2023  William Lee
+ *
+ *     This program is free software: you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation, either version 3 of the License, or
+ *     (at your option) any later version.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program.  If NOT, see <https://www.gnu.org/licenses/>.
+ *
+ * @file exfcgen.c
+ * @brief Registry code generator. Turns an exception definition file into a
+ *        header & a source file holding constant tables, ID constants and a
+ *        minimal perfect hash over names.
+ *
+ *        Usage: exfcgen DEFINITION OUTPUT_BASE
+ *        Writes OUTPUT_BASE.h & OUTPUT_BASE.c. Symbols are prefixed by the
+ *        last path component of OUTPUT_BASE. Also writes
+ *        OUTPUT_BASE_except.h, which holds enum Except_t for exfc.h and
+ *        includes nothing.
+ *
+ *        Every non-empty line of DEFINITION which does not begin with '#'
+ *        reads:  name | description | id | parent [| constant]
+ *        $parent is the name of another definition, or empty for a root.
+ *        $constant names the ID in enum Except_t; it defaults to $name.
+ *        Names & constants are unique all together, except that a
+ *        definition may take its own name as its constant.
+ * @version Alpha 0.0.0
+ * @author William Lee
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define EXFCGEN_LINE_MAX 8192
+
+/* Average keys per bucket of the perfect hash. */
+#define EXFCGEN_BUCKET_LOAD 4
+
+/* Seeds tried per bucket before giving up. */
+#define EXFCGEN_SEED_MAX 1000000u
+
+typedef struct _exfcgen_def_S
+{
+  char *_name;
+  char *_description;
+  char *_parent_name;
+  char *_constant;
+  unsigned long _name_len;
+  long _id;
+  int _parent;
+  int _line;
+} exfcgen_def;
+
+static exfcgen_def *defs = NULL;
+static int defs_len = 0;
+
+/* Names & constants of $defs, open addressing; index + 1 for a name,
+   -(index + 1) for a constant, 0 for empty. */
+static int *names = NULL;
+static unsigned int names_mask = 0;
+
+/* Must match _exfc_gen_hash emitted below, byte for byte in behaviour. */
+static unsigned int
+exfcgen_hash(const char *s, unsigned long len, unsigned int seed)
+{
+  unsigned int h = 2166136261u ^ (seed * 0x9E3779B9u);
+
+  for (unsigned long i = 0; i < len; i ++)
+    {
+      h ^= (unsigned char)s[i];
+      h *= 16777619u;
+    }
+
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+
+  return h;
+}
+
+static void
+die(const char *def, int line, const char *msg, const char *arg)
+{
+  (void)fprintf(stderr, "exfcgen: %s:%d: %s%s%s\n", def, line, msg,
+                (arg == NULL) ? "" : ": ", (arg == NULL) ? "" : arg);
+  exit(1);
+}
+
+static char *
+trim(char *s)
+{
+  while (isspace((unsigned char)*s))
+    {
+      s ++;
+    }
+
+  char *end = s + strlen(s);
+  while (end > s && isspace((unsigned char)end[-1]))
+    {
+      end --;
+    }
+  *end = '\0';
+
+  return s;
+}
+
+static int
+is_identifier(const char *s)
+{
+  if (!(isalpha((unsigned char)*s) || *s == '_'))
+    {
+      return 0;
+    }
+
+  for (s ++; *s != '\0'; s ++)
+    {
+      if (!(isalnum((unsigned char)*s) || *s == '_'))
+        {
+          return 0;
+        }
+    }
+  return 1;
+}
+
+static char *
+dup_str(const char *s)
+{
+  char *rtn = malloc(strlen(s) + 1);
+
+  if (rtn == NULL)
+    {
+      (void)fprintf(stderr, "exfcgen: out of memory\n");
+      exit(1);
+    }
+  return strcpy(rtn, s);
+}
+
+static void
+parse(const char *path)
+{
+  FILE *in = fopen(path, "r");
+
+  if (in == NULL)
+    {
+      die(path, 0, "cannot open", NULL);
+    }
+
+  char buff[EXFCGEN_LINE_MAX];
+  int line = 0;
+  int cap = 0;
+
+  while (fgets(buff, sizeof(buff), in) != NULL)
+    {
+      line += 1;
+
+      if (strchr(buff, '\n') == NULL && !feof(in))
+        {
+          die(path, line, "line too long", NULL);
+        }
+
+      char *s = trim(buff);
+      if (*s == '\0' || *s == '#')
+        {
+          continue;
+        }
+
+      char *field[5];
+      int n = 0;
+      field[n ++] = s;
+      for (char *p = s; *p != '\0'; p ++)
+        {
+          if (*p == '|')
+            {
+              if (n == 5)
+                {
+                  die(path, line, "too many fields", NULL);
+                }
+              *p = '\0';
+              field[n ++] = p + 1;
+            }
+        }
+
+      if (n < 4)
+        {
+          die(path, line,
+              "expected: name | description | id | parent [| constant]",
+              NULL);
+        }
+
+      for (int i = 0; i < n; i ++)
+        {
+          field[i] = trim(field[i]);
+        }
+
+      if (!is_identifier(field[0]))
+        {
+          die(path, line, "name is not an identifier", field[0]);
+        }
+
+      const char *constant = (n == 5 && *field[4] != '\0')
+                             ? field[4] : field[0];
+      if (!is_identifier(constant))
+        {
+          die(path, line, "constant is not an identifier", constant);
+        }
+
+      char *end = NULL;
+      const long id = strtol(field[2], &end, 0);
+      if (*field[2] == '\0' || *end != '\0' || id < 0 || id > 0x7FFFFFFFL)
+        {
+          die(path, line, "invalid id", field[2]);
+        }
+
+      if (defs_len == cap)
+        {
+          cap = (cap == 0) ? 64 : cap * 2;
+          defs = realloc(defs, sizeof(exfcgen_def) * (size_t)cap);
+
+          if (defs == NULL)
+            {
+              die(path, line, "out of memory", NULL);
+            }
+        }
+
+      defs[defs_len]._name = dup_str(field[0]);
+      defs[defs_len]._description = dup_str(field[1]);
+      defs[defs_len]._id = id;
+      defs[defs_len]._parent_name = dup_str(field[3]);
+      defs[defs_len]._constant = dup_str(constant);
+      defs[defs_len]._name_len = (unsigned long)strlen(field[0]);
+      defs[defs_len]._parent = -1;
+      defs[defs_len]._line = line;
+      defs_len += 1;
+    }
+
+  (void)fclose(in);
+}
+
+static int
+cmp_id(const void *a, const void *b)
+{
+  const long x = ((const exfcgen_def *)a)->_id;
+  const long y = ((const exfcgen_def *)b)->_id;
+
+  return ((x > y) - (x < y));
+}
+
+static const char *
+key_of(int entry)
+{
+  return ((entry > 0) ? defs[entry - 1]._name : defs[-entry - 1]._constant);
+}
+
+/* Entry of $names holding KEY, whether as a name or a constant; 0 once
+   none does. */
+static int
+find_key(const char *key)
+{
+  const unsigned long len = (unsigned long)strlen(key);
+
+  for (unsigned int b = exfcgen_hash(key, len, 0) & names_mask;
+       names[b] != 0; b = (b + 1) & names_mask)
+    {
+      if (strcmp(key_of(names[b]), key) == 0)
+        {
+          return names[b];
+        }
+    }
+  return 0;
+}
+
+static void
+insert_key(int entry)
+{
+  const char *key = key_of(entry);
+  unsigned int b = exfcgen_hash(key, (unsigned long)strlen(key), 0)
+                   & names_mask;
+  while (names[b] != 0)
+    {
+      b = (b + 1) & names_mask;
+    }
+  names[b] = entry;
+}
+
+static int
+find_name(const char *name)
+{
+  const int entry = find_key(name);
+
+  return ((entry > 0) ? entry - 1 : -1);
+}
+
+/* Fill $names; the first duplicated name or constant found is fatal. */
+static void
+index_names(const char *path)
+{
+  unsigned int cap = 1;
+  while (cap < (unsigned int)defs_len * 4)
+    {
+      cap <<= 1;
+    }
+
+  names = calloc(cap, sizeof(int));
+  if (names == NULL)
+    {
+      die(path, 0, "out of memory", NULL);
+    }
+  names_mask = cap - 1;
+
+  for (int i = 0; i < defs_len; i ++)
+    {
+      if (find_key(defs[i]._name) != 0)
+        {
+          die(path, defs[i]._line, "duplicated name", defs[i]._name);
+        }
+      insert_key(i + 1);
+
+      /* Its own name is the default constant. */
+      if (strcmp(defs[i]._constant, defs[i]._name) == 0)
+        {
+          continue;
+        }
+
+      if (find_key(defs[i]._constant) != 0)
+        {
+          die(path, defs[i]._line, "duplicated constant",
+              defs[i]._constant);
+        }
+      insert_key(-(i + 1));
+    }
+}
+
+/* Sort by ID, reject duplications and resolve parents. */
+static void
+validate(const char *path)
+{
+  if (defs_len == 0)
+    {
+      die(path, 0, "no definitions", NULL);
+    }
+
+  qsort(defs, (size_t)defs_len, sizeof(exfcgen_def), cmp_id);
+
+  for (int i = 1; i < defs_len; i ++)
+    {
+      if (defs[i]._id == defs[i - 1]._id)
+        {
+          die(path, defs[i]._line, "duplicated id", defs[i]._name);
+        }
+    }
+
+  index_names(path);
+
+  for (int i = 0; i < defs_len; i ++)
+    {
+      if (defs[i]._parent_name[0] == '\0')
+        {
+          continue;
+        }
+
+      defs[i]._parent = find_name(defs[i]._parent_name);
+      if (defs[i]._parent < 0)
+        {
+          die(path, defs[i]._line, "unknown parent", defs[i]._parent_name);
+        }
+    }
+
+  /* Reject cycles: every chain must reach a root within $defs_len steps. */
+  for (int i = 0; i < defs_len; i ++)
+    {
+      int p = i;
+      for (int step = 0; p >= 0; step ++)
+        {
+          if (step > defs_len)
+            {
+              die(path, defs[i]._line, "parent cycle", defs[i]._name);
+            }
+          p = defs[p]._parent;
+        }
+    }
+}
+
+/* Hash and displace. Keys are spread over buckets by seed 0; then, biggest
+   bucket first, every bucket searches for a seed placing all of its keys in
+   free slots. Lookup costs two hashes and one comparison. */
+static void
+build_phf(int nbucket, unsigned int *seed, int *slot)
+{
+  int *bucket_of = malloc(sizeof(int) * (size_t)defs_len);
+  int *first = calloc((size_t)nbucket + 1, sizeof(int));
+  int *member = malloc(sizeof(int) * (size_t)defs_len);
+  int *order = malloc(sizeof(int) * (size_t)nbucket);
+  unsigned int *trial = malloc(sizeof(unsigned int) * (size_t)defs_len);
+
+  if (bucket_of == NULL || first == NULL || member == NULL || order == NULL
+      || trial == NULL)
+    {
+      die("exfcgen", 0, "out of memory", NULL);
+    }
+
+  /* Group the keys by bucket once: bucket B owns
+     $member[$first[B]] .. $member[$first[B + 1] - 1]. */
+  for (int i = 0; i < defs_len; i ++)
+    {
+      bucket_of[i] = (int)(exfcgen_hash(defs[i]._name, defs[i]._name_len, 0)
+                           % (unsigned int)nbucket);
+      first[bucket_of[i] + 1] += 1;
+    }
+
+  for (int b = 0; b < nbucket; b ++)
+    {
+      first[b + 1] += first[b];
+      order[b] = b;
+      seed[b] = 0;
+    }
+
+  /* Placing moves every $first[B] to the start of B + 1; move back. */
+  for (int i = 0; i < defs_len; i ++)
+    {
+      member[first[bucket_of[i]] ++] = i;
+    }
+  for (int b = nbucket; b > 0; b --)
+    {
+      first[b] = first[b - 1];
+    }
+  first[0] = 0;
+
+#define EXFCGEN_SIZE(b) (first[(b) + 1] - first[(b)])
+
+  /* Insertion sort, biggest bucket first. */
+  for (int i = 1; i < nbucket; i ++)
+    {
+      const int cur = order[i];
+      int j = i;
+      while (j > 0 && EXFCGEN_SIZE(order[j - 1]) < EXFCGEN_SIZE(cur))
+        {
+          order[j] = order[j - 1];
+          j -= 1;
+        }
+      order[j] = cur;
+    }
+
+  for (int i = 0; i < defs_len; i ++)
+    {
+      slot[i] = -1;
+    }
+
+  for (int o = 0; o < nbucket && EXFCGEN_SIZE(order[o]) > 0; o ++)
+    {
+      const int b = order[o];
+      const int *keys = &member[first[b]];
+      const int nkey = EXFCGEN_SIZE(b);
+      unsigned int s = 1;
+
+      for (; s < EXFCGEN_SEED_MAX; s ++)
+        {
+          int ok = 1;
+
+          for (int n = 0; n < nkey && ok; n ++)
+            {
+              const exfcgen_def *d = &defs[keys[n]];
+              const unsigned int h = exfcgen_hash(d->_name, d->_name_len, s)
+                                     % (unsigned int)defs_len;
+
+              if (slot[h] >= 0)
+                {
+                  ok = 0;
+                }
+
+              for (int k = 0; k < n && ok; k ++)
+                {
+                  if (trial[k] == h)
+                    {
+                      ok = 0;
+                    }
+                }
+              trial[n] = h;
+            }
+
+          if (ok)
+            {
+              break;
+            }
+        }
+
+      if (s == EXFCGEN_SEED_MAX)
+        {
+          die("exfcgen", 0, "cannot build perfect hash", NULL);
+        }
+
+      seed[b] = s;
+      for (int n = 0; n < nkey; n ++)
+        {
+          slot[trial[n]] = keys[n];
+        }
+    }
+
+#undef EXFCGEN_SIZE
+
+  free(bucket_of);
+  free(first);
+  free(member);
+  free(order);
+  free(trial);
+}
+
+static void
+put_c_string(FILE *out, const char *s)
+{
+  (void)fputc('"', out);
+  for (; *s != '\0'; s ++)
+    {
+      const unsigned char c = (unsigned char)*s;
+
+      if (c == '"' || c == '\\')
+        {
+          (void)fprintf(out, "\\%c", c);
+        }
+      else if (isprint(c))
+        {
+          (void)fputc(c, out);
+        }
+      else
+        {
+          /* Octal escapes cannot swallow following digits past 3. */
+          (void)fprintf(out, "\\%03o", c);
+        }
+    }
+  (void)fputc('"', out);
+}
+
+static FILE *
+open_out(const char *base, const char *ext)
+{
+  char path[strlen(base) + strlen(ext) + 1];
+
+  (void)strcpy(path, base);
+  (void)strcat(path, ext);
+
+  FILE *out = fopen(path, "w");
+  if (out == NULL)
+    {
+      die(path, 0, "cannot create", NULL);
+    }
+  return out;
+}
+
+static void
+emit(const char *def, const char *base)
+{
+  const char *prefix = strrchr(base, '/');
+  prefix = (prefix == NULL) ? base : prefix + 1;
+
+  if (!is_identifier(prefix))
+    {
+      die(base, 0, "output name is not an identifier", prefix);
+    }
+
+  char upper[strlen(prefix) + 1];
+  for (size_t i = 0; i <= strlen(prefix); i ++)
+    {
+      upper[i] = (char)toupper((unsigned char)prefix[i]);
+    }
+
+  int nbucket = (defs_len + EXFCGEN_BUCKET_LOAD - 1) / EXFCGEN_BUCKET_LOAD;
+  unsigned int seed[nbucket];
+  int slot[defs_len];
+  build_phf(nbucket, seed, slot);
+
+  /* Header */
+  FILE *h = open_out(base, ".h");
+  (void)fprintf(h,
+"/* Generated by exfcgen from %s. Do NOT edit. */\n\n"
+"#ifndef %s_H\n"
+"# define %s_H\n\n"
+"# include \"exfc.h\"\n\n"
+"# define %s_LEN %d\n\n"
+"enum %s_id {\n", def, upper, upper, upper, defs_len, prefix);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(h, "  %s_%s = %ld%s\n", upper, defs[i]._name,
+                    defs[i]._id, (i + 1 == defs_len) ? "" : ",");
+    }
+  (void)fprintf(h,
+"};\n\n"
+"/* Sorted by ID. */\n"
+"extern const _excep_t %s_table[%s_LEN];\n\n"
+"/* Index of the parent in $%s_table, or -1 for roots. */\n"
+"extern const int %s_parent[%s_LEN];\n\n"
+"/**\n"
+" * @brief Find an exception in $%s_table by its name with one perfect\n"
+" *        hash probe.\n"
+" * @return Index in $%s_table;\\n\n"
+" * @return @b MISSING once NOT found;\\n\n"
+" * @return @b FAILED  once failed passing through macro \"fail\";\n"
+" */\n"
+"int\n"
+"%s_getindex_byname(const char *name);\n\n"
+"/**\n"
+" * @brief Find an exception in $%s_table by its ID.\n"
+" * @return Index in $%s_table;\\n\n"
+" * @return @b MISSING once NOT found;\n"
+" */\n"
+"int\n"
+"%s_getindex_byid(int id);\n\n"
+"/**\n"
+" * @brief Add every exception in $%s_table with exfc_addexcep.\n"
+" * @return Amount of exceptions added;\\n\n"
+" * @return The first failure returned by exfc_addexcep;\n"
+" */\n"
+"int\n"
+"%s_register();\n\n"
+"#endif /* NO %s_H */\n",
+                prefix, upper, prefix, prefix, upper, prefix, prefix,
+                prefix, prefix, prefix, prefix, prefix, prefix, upper);
+  if (fclose(h) != 0)
+    {
+      die(base, 0, "cannot write header", NULL);
+    }
+
+  /* Enumeration for exfc.h, which cannot include the header above. */
+  FILE *e = open_out(base, "_except.h");
+  (void)fprintf(e,
+"/* Generated by exfcgen from %s. Do NOT edit. */\n\n"
+"#ifndef %s_EXCEPT_H\n"
+"# define %s_EXCEPT_H\n\n"
+"/**\n"
+" * @enum An enumeration declares all predefined exceptions.\n"
+" */\n"
+"enum Except_t {\n", def, upper, upper);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(e, "  %s = %ld%s\n", defs[i]._constant, defs[i]._id,
+                    (i + 1 == defs_len) ? "" : ",");
+    }
+  (void)fprintf(e, "};\n\n#endif /* NO %s_EXCEPT_H */\n", upper);
+  if (fclose(e) != 0)
+    {
+      die(base, 0, "cannot write enumeration", NULL);
+    }
+
+  /* Source */
+  FILE *c = open_out(base, ".c");
+  (void)fprintf(c,
+"/* Generated by exfcgen from %s. Do NOT edit. */\n\n"
+"#include <string.h>\n\n"
+"#include \"%s.h\"\n\n"
+"const _excep_t %s_table[%s_LEN] = {\n", def, prefix, prefix, upper);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(c, "  {(char *)");
+      put_c_string(c, defs[i]._name);
+      (void)fprintf(c, ", (char *)");
+      put_c_string(c, defs[i]._description);
+      (void)fprintf(c, ", %s_%s}%s\n", upper, defs[i]._name,
+                    (i + 1 == defs_len) ? "" : ",");
+    }
+
+  (void)fprintf(c, "};\n\nconst int %s_parent[%s_LEN] = {", prefix, upper);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(c, "%s%s%d", (i == 0) ? "" : ",",
+                    (i % 16 == 0) ? "\n  " : " ", defs[i]._parent);
+    }
+
+  (void)fprintf(c, "\n};\n\nstatic const unsigned int _%s_len[%s_LEN] = {",
+                prefix, upper);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(c, "%s%s%lu", (i == 0) ? "" : ",",
+                    (i % 16 == 0) ? "\n  " : " ",
+                    defs[i]._name_len);
+    }
+
+  (void)fprintf(c, "\n};\n\nstatic const unsigned int _%s_seed[%d] = {",
+                prefix, nbucket);
+  for (int b = 0; b < nbucket; b ++)
+    {
+      (void)fprintf(c, "%s%s%uu", (b == 0) ? "" : ",",
+                    (b % 8 == 0) ? "\n  " : " ", seed[b]);
+    }
+
+  (void)fprintf(c, "\n};\n\nstatic const int _%s_slot[%s_LEN] = {",
+                prefix, upper);
+  for (int i = 0; i < defs_len; i ++)
+    {
+      (void)fprintf(c, "%s%s%d", (i == 0) ? "" : ",",
+                    (i % 16 == 0) ? "\n  " : " ", slot[i]);
+    }
+
+  (void)fprintf(c,
+"\n};\n\n"
+"static inline unsigned int\n"
+"_%s_hash(const char *s, unsigned long len, unsigned int seed)\n"
+"{\n"
+"  unsigned int h = 2166136261u ^ (seed * 0x9E3779B9u);\n\n"
+"  for (register unsigned long i = 0; i < len; i ++)\n"
+"    {\n"
+"      h ^= (unsigned char)s[i];\n"
+"      h *= 16777619u;\n"
+"    }\n\n"
+"  h ^= h >> 16;\n"
+"  h *= 0x85EBCA6Bu;\n"
+"  h ^= h >> 13;\n"
+"  h *= 0xC2B2AE35u;\n"
+"  h ^= h >> 16;\n\n"
+"  return h;\n"
+"}\n\n"
+"int\n"
+"%s_getindex_byname(const char *name)\n"
+"{\n"
+"  EXFC_FAILS(name, FAILED);\n\n"
+"  const unsigned long len = strlen(name);\n"
+"  const unsigned int b = _%s_hash(name, len, 0) %% %du;\n"
+"  const int i = _%s_slot[_%s_hash(name, len, _%s_seed[b]) %% %s_LEN];\n\n"
+"  if (_%s_len[i] == len && memcmp(%s_table[i]._name, name, len) == 0)\n"
+"    {\n"
+"      return i;\n"
+"    }\n"
+"  return MISSING;\n"
+"}\n\n"
+"int\n"
+"%s_getindex_byid(int id)\n"
+"{\n"
+"  int lo = 0;\n"
+"  int hi = %s_LEN;\n\n"
+"  while (lo < hi)\n"
+"    {\n"
+"      const int mid = lo + (hi - lo) / 2;\n\n"
+"      if (%s_table[mid]._id == id)\n"
+"        {\n"
+"          return mid;\n"
+"        }\n\n"
+"      if (%s_table[mid]._id < id)\n"
+"        {\n"
+"          lo = mid + 1;\n"
+"        }\n"
+"      else\n"
+"        {\n"
+"          hi = mid;\n"
+"        }\n"
+"    }\n"
+"  return MISSING;\n"
+"}\n\n"
+"int\n"
+"%s_register()\n"
+"{\n"
+"  for (register int i = 0; i < %s_LEN; i ++)\n"
+"    {\n"
+"      const int add = exfc_addexcep(%s_table[i]._name,\n"
+"                                    %s_table[i]._description,\n"
+"                                    %s_table[i]._id);\n\n"
+"      if (add < 0)\n"
+"        {\n"
+"          return add;\n"
+"        }\n"
+"    }\n"
+"  return %s_LEN;\n"
+"}\n",
+                prefix, prefix, prefix, nbucket, prefix, prefix, prefix,
+                upper, prefix, prefix, prefix, upper, prefix, prefix,
+                prefix, upper, prefix, prefix, prefix, upper);
+  if (fclose(c) != 0)
+    {
+      die(base, 0, "cannot write source", NULL);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 3)
+    {
+      (void)fprintf(stderr, "usage: %s DEFINITION OUTPUT_BASE\n", argv[0]);
+      return 2;
+    }
+
+  parse(argv[1]);
+  validate(argv[1]);
+  emit(argv[1], argv[2]);
+
+  return 0;
+}